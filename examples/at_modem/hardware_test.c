@@ -14,6 +14,7 @@
 #include <stdarg.h>
 #include <unistd.h>
 #include "at.h"
+#include "myriota_format.h"
 
 #define TEST_COMMAND_LEN 50
 
@@ -161,7 +162,7 @@ static bool GNSSTest(bool CommTestOnly) {
       int32_t lat, lon;
       time_t timestamp;
       LocationGet(&lat, &lon, &timestamp);
-      PRINT("GNSS test passed: %f %f %u\n", lat * 1e-7, lon * 1e-7,
+      PRINT("GNSS test passed: %s %s %u\n", COORD_STR(lat), COORD_STR(lon),
             (unsigned int)timestamp);
     }
   }
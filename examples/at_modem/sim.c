@@ -14,7 +14,6 @@
 // The simulation code for the at_modem example. This is only included when
 // building the application for the host simulator.
 
-#include <fcntl.h>
 #include <signal.h>
 #include <string.h>
 #include <unistd.h>
@@ -28,26 +27,9 @@ void LedTurnOn(void) {}
 void LedTurnOff(void) {}
 void LedToggle(void) {}
 
-int GPIOSetModeOutput(uint8_t PinNum) { return 0; }
-int GPIOSetHigh(uint8_t PinNum) { return 0; }
-int GPIOSetLow(uint8_t PinNum) { return 0; }
-
-void *UARTInit(UARTInterface UARTNum, uint32_t BaudRate, uint32_t Options) {
-  return (void *)0xDEADBEEF;
-}
-
-void UARTDeinit(void *Handle) {}
-
-int UARTWrite(void *Handle, const uint8_t *Tx, size_t Length) {
-  fwrite(Tx, 1, Length, stderr);
-  return 0;
-}
-
-int UARTRead(void *Handle, uint8_t *Rx, size_t Length) {
-  int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
-  fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
-  return read(STDIN_FILENO, Rx, Length);
-}
+// AT responses go to stderr, apart from the application's output. Set
+// SIMLEUART to "pty" to talk to the modem from a terminal program instead.
+const int SimUARTStdout = STDERR_FILENO;
 
 int RFTestRxRSSI(int32_t *RSSI) {
   *RSSI = -90;
@@ -58,11 +40,6 @@ char *ModuleIDGet(void) { return "00749f046b M1-24"; }
 
 char *RegistrationCodeGet(void) { return "g3z59x4e9frdt1j4ydmnb6jqy"; }
 
-int GPIOSetModeInput(uint8_t PinNum, GPIOPull Pull) { return 0; }
-
-#define GPIO_DONT_CARE GPIO_LOW
-int GPIOGet(uint8_t PinNum) { return GPIO_DONT_CARE; }
-
 int RFTestTxStart(uint32_t Frequency, uint8_t TxType, bool IsBurst) {
   if (Frequency < 142000000 || Frequency > 525000000 ||
       (Frequency > 175000000 && Frequency < 350000000)) {
@@ -85,6 +62,7 @@ void RFTestRxStop(void) {}
 int GNSSFix(void) { return gnss_return; }
 
 time_t ScheduleHook(time_t Next) {
+  SimDurationCheck();
   raise(SIGUSR1);  // raise signal to simulate leuart activity
   return 0;        // return time of wakeup event
 }
@@ -14,34 +14,11 @@
 // The simulation code for the event example. This is only included when
 // building the application for the simulator platform.
 
-#include <signal.h>
-#include <unistd.h>
 #include "myriota_user_api.h"
 
 // Run "kill -l 10 processid" to generate events. The processid is
 // printed when the simulation starts
 
-static uint8_t pin_state = GPIO_LOW;  // Current pin state
-
-int GPIOSetWakeupLevel(uint8_t PinNum, GPIOLevel Level) { return 0; }
-
-int GPIOGet(uint8_t PinNum) { return pin_state; }
-
-int GPIOSetModeInput(uint8_t PinNum, GPIOPull Pull) { return 0; }
-
-// Generate the GPIO wakeup event every hour
-time_t ScheduleHook(time_t Next) {
-  // current time rounded up to the next hour
-  const time_t next_event = (TimeGet() / 3600 + 1) * 3600;
-
-  // wakeup time is before the next hour return 0 to indicate no event
-  if (next_event >= Next) return 0;
-
-  // wakeup on the next hour
-  if (pin_state == GPIO_LOW)
-    pin_state = GPIO_HIGH;
-  else
-    pin_state = GPIO_LOW;
-  raise(SIGUSR1);     // raise signal to indicate wakeup event
-  return next_event;  // return time of wakeup event
-}
+// Toggle the wakeup pin (PIN_GPIO0_WKUP) every hour. Set SIMTIMELINE to a
+// timeline file to generate other events.
+const char SimTimelineDefault[] = "/1h gpio 24 toggle\n";
@@ -11,9 +11,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <signal.h>
 #include <stdlib.h>
-#include <unistd.h>
 #include "myriota_user_api.h"
 
 // Run "kill -l 10 processid" to generate events. The processid is
@@ -23,7 +21,10 @@
 static uint32_t PulseCounterLimit = 0;
 static uint32_t PulseCounterOptions = 0;
 static bool PulseCounterInited = false;
-uint64_t Counter = 0;
+
+// Count 6 pulses every hour. Set SIMTIMELINE to a timeline file to generate
+// other events.
+const char SimTimelineDefault[] = "/1h pulse 6\n";
 
 int PulseCounterInit(uint32_t Limit, uint32_t Options) {
   if (PulseCounterInited) {
@@ -39,22 +40,5 @@ int PulseCounterInit(uint32_t Limit, uint32_t Options) {
 uint64_t PulseCounterGet() {
   if (!PulseCounterInited) return 0;
 
-  return Counter;
-}
-
-int GPIOSetModeInput(uint8_t PinNum, GPIOPull Pull) { return 0; }
-
-// Generate the pulse counter event every hour
-time_t ScheduleHook(time_t Next) {
-  time_t WakeupInterval = 3600;
-
-  // current time rounded up to the next hour
-  const time_t next_event = (TimeGet() / WakeupInterval + 1) * WakeupInterval;
-
-  // wakeup time is before the next hour return 0 to indicate no event
-  if (next_event >= Next) return 0;
-
-  Counter += PulseCounterLimit;
-  raise(SIGUSR1);     // raise signal to indicate wakeup event
-  return next_event;  // return time of wakeup event
+  return SimTimelinePulses();
 }
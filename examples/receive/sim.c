@@ -16,6 +16,7 @@
 
 #include <string.h>
 #include <unistd.h>
+#include "myriota_user_api.h"
 
 #ifndef GNSS_SIM_FIX_STATUS
 // 0-success, 1-fail
@@ -23,3 +24,6 @@
 #endif
 
 int GNSSFix(void) { return GNSS_SIM_FIX_STATUS; }
+
+// Messages sent by the downlink events of the SIMTIMELINE file
+uint8_t *ReceiveMessage(int *size) { return SimTimelineDownlink(size); }
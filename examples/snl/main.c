@@ -17,13 +17,15 @@
 // in mV. The application handles wakeup button and vibration sensor events as
 // well.
 
+#include "myriota_format.h"
+#include "myriota_protothread.h"
 #include "myriota_user_api.h"
 
 #define VIBRATION_SENSOR_ENABLED false  // true to enable vibration sensor
 
 #define LED_DELAY 200              // ms
 #define SHUNT_RESISTANCE 100       // ohm
-#define SENSOR_TOLERANCE 0.1f      // +-10%
+#define SENSOR_TOLERANCE 10        // +-%
 #define SENSOR_TEST_INTERVAL 5000  // ms
 
 const static uint8_t ButtonGPIO = PIN_GPIO0_WKUP;
@@ -60,19 +62,25 @@ static void LedBlink(uint8_t count) {
   }
 }
 
-static int ReadSensor(uint32_t *value) {
-  GPIOSetHigh(GPIO_4_20_ENABLE);
-  Delay(DELAY_MS_21V_STABILISE);
+// Number of readings waiting for the sensor to stabilise, the jobs can
+// overlap while they sleep
+static int sensor_users = 0;
 
+static void SensorEnable(void) {
+  if (sensor_users++ == 0) GPIOSetHigh(GPIO_4_20_ENABLE);
+}
+
+// Reads the sensor enabled DELAY_MS_21V_STABILISE ago and disables it
+static int ReadSensor(uint32_t *value) {
   int result = ADCGetVoltage(PIN_ADC0, ADC_REF_2V5, value);
   if (result != 0) printf("Error reading sensor: %i", result);
 
-  GPIOSetLow(GPIO_4_20_ENABLE);
+  if (--sensor_users == 0) GPIOSetLow(GPIO_4_20_ENABLE);
 
   return result;
 }
 
-static uint32_t MeasureCurrent() {
+static uint32_t SensorCurrent(void) {
   uint32_t mv, ua = 0;
 
   if (ReadSensor(&mv) != 0)
@@ -85,9 +93,17 @@ static uint32_t MeasureCurrent() {
   return ua;
 }
 
+// Blocking measurement for BoardStart, the jobs sleep while the sensor
+// stabilises instead
+static uint32_t MeasureCurrent() {
+  SensorEnable();
+  Delay(DELAY_MS_21V_STABILISE);
+  return SensorCurrent();
+}
+
 static void DisplaySensorResult(uint32_t current) {
-  if (current < 4000 * (1 - SENSOR_TOLERANCE) ||
-      current > 20000 * (1 + SENSOR_TOLERANCE)) {
+  if (current < 4000 * (100 - SENSOR_TOLERANCE) / 100 ||
+      current > 20000 * (100 + SENSOR_TOLERANCE) / 100) {
     if (current < 200) {
       printf("Sensor disconnected\n");
       LedBlink(3);
@@ -102,18 +118,23 @@ static void DisplaySensorResult(uint32_t current) {
 }
 
 static time_t SendMessage(void) {
+  static Protothread pt;
   static uint16_t sequence_number = 0;
+  static time_t next_schedule;
   int32_t lat, lon;
-  time_t next_schedule;
   uint32_t timestamp, current, volt_32;
 
+  PT_BEGIN(&pt);
   next_schedule = TimeGet() + 24 * 3600 / MESSAGE_PER_DAY;
 
   if (GNSSFix()) printf("Failed to get GNSS Fix, using last known fix\n");
-  LocationGet(&lat, &lon, NULL);
 
+  SensorEnable();
+  PT_SLEEP_MS(&pt, DELAY_MS_21V_STABILISE);
+
+  LocationGet(&lat, &lon, NULL);
   timestamp = TimeGet();
-  current = MeasureCurrent();
+  current = SensorCurrent();
   BatteryGetVoltage(&volt_32);
   uint16_t voltage = (uint16_t)volt_32;
 
@@ -121,24 +142,30 @@ static time_t SendMessage(void) {
                                   timestamp,       current, voltage};
   ScheduleMessage((void *)&message, sizeof(message));
 
-  printf("Scheduled message: %u %f %f %u %u %u\n", sequence_number, lat * 1e-7,
-         lon * 1e-7, (unsigned int)timestamp, (unsigned int)current, voltage);
+  printf("Scheduled message: %u %s %s %u %u %u\n", sequence_number,
+         COORD_STR(lat), COORD_STR(lon), (unsigned int)timestamp,
+         (unsigned int)current, voltage);
 
   sequence_number++;
 
-  return next_schedule;
+  PT_END(&pt, next_schedule);
 }
 
 static time_t RunsOnGPIOWakeup() {
-  if (GPIOGet(ButtonGPIO) == GPIO_HIGH) {
-    DisplaySensorResult(MeasureCurrent());
-  }
+  static Protothread pt;
 
+  PT_BEGIN(&pt);
   if (VIBRATION_SENSOR_ENABLED && GPIOGet(VibrationGPIO) == GPIO_LOW) {
     printf("Woken up by vibration sensor at %u\n", (unsigned int)TimeGet());
   }
 
-  return OnGPIOWakeup();
+  if (GPIOGet(ButtonGPIO) == GPIO_HIGH) {
+    SensorEnable();
+    PT_SLEEP_MS(&pt, DELAY_MS_21V_STABILISE);
+    DisplaySensorResult(SensorCurrent());
+  }
+
+  PT_END(&pt, OnGPIOWakeup());
 }
 
 void AppInit() {
@@ -21,16 +21,6 @@ static const uint32_t voltage_list[6] = {19, 20, 359, 360, 2200, 2201};
 
 static uint8_t pin_state = GPIO_LOW;  // Current pin state
 
-int GPIOSetHigh(uint8_t PinNum) { return 0; }
-
-int GPIOSetLow(uint8_t PinNum) { return 0; }
-
-int GPIOSetModeInput(uint8_t PinNum, GPIOPull Pull) { return 0; }
-
-int GPIOSetWakeupLevel(uint8_t PinNum, GPIOLevel Level) { return 0; }
-
-int GPIOSetModeOutput(uint8_t PinNum) { return 0; }
-
 void LedTurnOn(void) {}
 
 void LedTurnOff(void) {}
@@ -46,6 +36,7 @@ int ADCGetVoltage(uint8_t PinNum, ADCReference Reference, uint32_t *mV) {
 
 // Generate GPIO wakeup event
 time_t ScheduleHook(time_t Next) {
+  SimDurationCheck();
   const time_t next_event = TimeGet() + 5;
 
   // wakeup time is before the next, return 0 to indicate no event
@@ -17,6 +17,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include "myriota_format.h"
 #include "myriota_user_api.h"
 
 #ifndef LOCATIONS_PER_MESSAGE
@@ -53,8 +54,8 @@ static void SendMessage(const tracker_message *msg) {
 
   printf("Scheduled message: %u %u", msg->sequence_number, msg->location_count);
   for (int i = 0; i < msg->location_count; i++)
-    printf(" %f %f %u", msg->locations[i].latitude / 1e7,
-           msg->locations[i].longitude / 1e7,
+    printf(" %s %s %u", COORD_STR(msg->locations[i].latitude),
+           COORD_STR(msg->locations[i].longitude),
            (unsigned int)msg->locations[i].time);
   printf("\n");
 }
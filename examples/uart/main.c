@@ -37,6 +37,9 @@ const static uint8_t GPIOPin = PIN_GPIO0_WKUP;
 
 // Read new line terminated string from UART with timeout
 // Return number of bytes read or -1 on timeout or string is too long
+// This polls rather than yielding with PT_WAIT_UNTIL from
+// myriota_protothread.h, as a job can't wait for LEUART activity and a
+// timeout at once, and UART_0 doesn't receive while the module sleeps.
 int UARTReadStringWithTimeout(void *Handle, uint8_t *Rx, size_t MaxLength) {
   const uint32_t start = TickGet();
   int count = 0;
@@ -15,39 +15,8 @@
 // building the application for the simulator platform. This simulator schedules
 // a message for transmission every 8 hours.
 
-#include <fcntl.h>
-#include <signal.h>
-#include <string.h>
-#include <unistd.h>
 #include "myriota_user_api.h"
 
-int GPIOSetWakeupLevel(uint8_t PinNum, GPIOLevel Level) { return 0; }
-int GPIOSetModeInput(uint8_t PinNum, GPIOPull Pull) { return 0; }
-
-void *UARTInit(UARTInterface UARTNum, uint32_t BaudRate, uint32_t Options) {
-  return (void *)0xDEADBEEF;
-}
-void UARTDeinit(void *Handle) {}
-
-int UARTWrite(void *Handle, const uint8_t *Tx, size_t Length) {
-  fwrite(Tx, 1, Length, stdout);
-  return 0;
-}
-
-int UARTRead(void *Handle, uint8_t *Rx, size_t Length) {
-  int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
-  fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
-  return read(STDIN_FILENO, Rx, Length);
-}
-
-#define EIGHT_HOURS (8 * 60 * 60)
-
-// Wake modem every 8 hours and schedule a message
-time_t ScheduleHook(time_t Next) {
-  const time_t next_event = (TimeGet() / EIGHT_HOURS + 1) * EIGHT_HOURS;
-
-  if (next_event >= Next) return 0;  // zero to indicate no event
-
-  raise(SIGUSR1);     // raise signal to simulate GPIO wakeup event
-  return next_event;  // return time of wakeup event
-}
+// Wake the module every 8 hours. Set SIMTIMELINE to a timeline file to send
+// it LEUART data, which is read before stdin.
+const char SimTimelineDefault[] = "/8h wake\n";
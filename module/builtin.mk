@@ -40,32 +40,63 @@ $(LATEST_NETWORK_INFO):
 	@(curl -s -f $(NETWORK_URL)/$(SATELLITES) -o $@.bin && echo "Latest network information has been downloaded to $@.bin.") || \
 	echo "Failed to download latest network information."
 
-builtin:=$(shell mktemp)
-buildkey:=$(shell mktemp -u)
+# Generated files live in $(OBJ_DIR). The build key is made afresh on every
+# build.
+builtin:=$(OBJ_DIR)/builtin_networkinfo
+buildkey:=$(OBJ_DIR)/buildkey
+.PHONY: $(buildkey)
 
 SDK_VERSION?=$(shell cat $(ROOTDIR)/VERSION)
 
 $(buildkey):
+	@rm -f $@
 	@printf "0: %08x" $$(date +%s) | xxd -r - $@
 	@echo $(SDK_VERSION) | awk -F"." '{printf ("4: %02x%02x%02x", $$1,$$2,$$3)}' | xxd -r - $@
 	@openssl rand 9 >> $@
 	@cat /dev/zero | head -c16 >> $@
 	@printf "BuildKey: $$(cat $@ | xxd -ps -c32)\n"
 
+# Objects to link in place of the generated C arrays. The blobs are pulled
+# in by the assembler with .incbin rather than compiled as initialiser lists.
+ifeq ($(BUILD_WITH_NETWORKINFO), 1)
+BUILTIN_OBJ:=$(builtin).o $(builtin)_blob.o
+else
+BUILTIN_OBJ:=$(builtin).o
+endif
+BUILDKEY_OBJ:=$(buildkey).o $(buildkey)_blob.o
+
+# emit assembler that embeds files $(2) as hidden symbol $(1), followed by the
+# bytes $(3) if given
+define incbin_source
+	@printf '\t.section .rodata.$(1),"a"\n\t.balign 4\n' > $@
+	@printf '\t.global $(1)\n\t.hidden $(1)\n$(1):\n' >> $@
+	@for f in $(abspath $(2)); do printf '\t.incbin "%s"\n' $$f >> $@; done
+	$(if $(3),@printf '\t.byte $(3)\n' >> $@)
+	@printf '\t.size $(1), . - $(1)\n' >> $@
+	@printf '\t.section .note.GNU-stack,"",%%progbits\n' >> $@
+endef
+
+%_blob.o: %_blob.S
+	@$(CC) $(CFLAGS) -c $< -o $@
+
 # create built-in source with updated orbit models
 $(builtin).c: $(NETWORK_INFO)
 	@printf "#include <inttypes.h>\n#include <stddef.h>\n" > $@
 ifeq ($(BUILD_WITH_NETWORKINFO), 1)
-	@printf "const uint8_t* BuiltinNetworkInfo() { static const uint8_t b[] = {" >> $@
-	@dd if=/dev/zero bs=1 count=1 status=none | cat $^ - | xxd -i | tr -d \\n >> $@
-	@printf "}; return b; }\n" >> $@
+	@printf "extern const uint8_t BuiltinNetworkInfoData[];\n" >> $@
+	@printf "const uint8_t* BuiltinNetworkInfo() { return BuiltinNetworkInfoData; }\n" >> $@
 else
 	@printf "const uint8_t* BuiltinNetworkInfo() { return NULL; }\n" >> $@
 endif
 
+$(builtin)_blob.S: $(NETWORK_INFO)
+	$(call incbin_source,BuiltinNetworkInfoData,$^,0)
+
 # create build key source for simulation
 $(buildkey).c: $(buildkey)
 	@printf "#include <inttypes.h>\n" > $@
-	@printf "const uint8_t* BuildKey() { static const uint8_t k[] = {" >> $@
-	@cat $(buildkey) | xxd -i | tr -d \\n >> $@
-	@printf "}; return k; }" >> $@
+	@printf "extern const uint8_t BuildKeyData[];\n" >> $@
+	@printf "const uint8_t* BuildKey() { return BuildKeyData; }" >> $@
+
+$(buildkey)_blob.S: $(buildkey)
+	$(call incbin_source,BuildKeyData,$^)
@@ -0,0 +1,84 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Event bus jobs, one per event source, each delivering its events to the
+// subscribers of the source in priority order. A subscriber that was
+// delivered an event less than Debounce seconds ago is skipped.
+
+#include "myriota_event_bus.h"
+
+static void EventDeliver(EventSource Source, const uint8_t *Data, int Size) {
+  const Event Evt = {Source, TimeGet(), Data, Size};
+  int Priority = -1;
+
+  // Each pass delivers the next priority, in table order
+  while (Priority < UINT8_MAX) {
+    int Next = UINT8_MAX + 1;
+    bool Stop = false;
+    for (EventSubscriber *s = EventSubscribers; s->Callback; s++) {
+      if (s->Source != Source) continue;
+      if (s->Priority > Priority && s->Priority < Next) Next = s->Priority;
+      if (s->Priority != Priority) continue;
+      if (s->LastDelivery && Evt.Time - s->LastDelivery < (time_t)s->Debounce)
+        continue;
+      s->LastDelivery = Evt.Time;
+      if (s->Callback(&Evt)) Stop = true;
+    }
+    if (Stop) return;
+    Priority = Next;
+  }
+}
+
+static time_t GPIOEventJob(void) {
+  EventDeliver(EVENT_GPIO, NULL, 0);
+  return OnGPIOWakeup();
+}
+
+static time_t PulseCounterEventJob(void) {
+  EventDeliver(EVENT_PULSE_COUNTER, NULL, 0);
+  return OnPulseCounterEvent();
+}
+
+static time_t LeuartEventJob(void) {
+  EventDeliver(EVENT_LEUART, NULL, 0);
+  return OnLeuartReceive();
+}
+
+static time_t DownlinkEventJob(void) {
+  int Size;
+  const uint8_t *Data = ReceiveMessage(&Size);
+
+  if (Size > 0) EventDeliver(EVENT_DOWNLINK, Data, Size);
+  return OnReceiveMessage();
+}
+
+int EventBusStart(void) {
+  static const struct {
+    ScheduledJob Job;
+    time_t (*Event)(void);
+  } Sources[EVENT_SOURCES] = {
+      [EVENT_GPIO] = {GPIOEventJob, OnGPIOWakeup},
+      [EVENT_PULSE_COUNTER] = {PulseCounterEventJob, OnPulseCounterEvent},
+      [EVENT_LEUART] = {LeuartEventJob, OnLeuartReceive},
+      [EVENT_DOWNLINK] = {DownlinkEventJob, OnReceiveMessage},
+  };
+  bool Used[EVENT_SOURCES] = {false};
+
+  for (EventSubscriber *s = EventSubscribers; s->Callback; s++)
+    if (s->Source < EVENT_SOURCES) Used[s->Source] = true;
+  for (int i = 0; i < EVENT_SOURCES; i++) {
+    if (Used[i] && ScheduleJob(Sources[i].Job, Sources[i].Event()) != 0)
+      return -1;
+  }
+  return 0;
+}
@@ -19,6 +19,7 @@ RAW_BINARY_DIR:=raw_binary
 BUILD_WITH_NETWORKINFO?=0
 
 include $(ROOTDIR)/module/g2/flags.mk
+include $(ROOTDIR)/module/job_profile.mk
 include $(ROOTDIR)/module/builtin.mk
 
 PROGRAM_NAME?=app
@@ -49,7 +50,7 @@ ifeq (,$(findstring bsp.c,$(APP_SRC)))
 APP_SRC+=$(BSP_PATH)/bsp.c
 endif
 APP_OBJ:=$(patsubst %.c, $(OBJ_DIR)/%.o, $(APP_SRC))
-SDK_OBJ:=$(builtin).o
+SDK_OBJ:=$(BUILTIN_OBJ)
 OBJ_LIST+=$(APP_OBJ)
 OBJ_LIST+=$(SDK_OBJ)
 
@@ -78,6 +79,36 @@ endif
 $(OBJ_DIR)/$(PROGRAM_NAME_ELF): $(LIBS) $(OBJ_LIST)
 	$(CC) $(OBJ_LIST) -Wl,--print-memory-usage -Wl,--whole-archive $(LIBS) $(LDFLAGS) -Wl,--no-whole-archive -o $@
 
+# Flash and RAM usage report from the link map. mem_report fails when a region
+# or section grows by more than MEM_THRESHOLD (bytes or N%) over MEM_BASELINE,
+# mem_baseline records the current usage as the new baseline.
+MEM_BASELINE?=mem_baseline.json
+MEM_THRESHOLD?=0
+
+.PHONY: mem_report mem_baseline
+mem_report: $(OBJ_DIR)/$(PROGRAM_NAME_ELF)
+	$(ROOTDIR)/tools/mem_report.py $(OBJ_DIR)/map.out -b $(MEM_BASELINE) -t $(MEM_THRESHOLD)
+
+mem_baseline: $(OBJ_DIR)/$(PROGRAM_NAME_ELF)
+	$(ROOTDIR)/tools/mem_report.py $(OBJ_DIR)/map.out -b $(MEM_BASELINE) -u
+
+# Worst-case stack depth of BoardStart, AppInit and every ScheduleJob job.
+# The application objects are rebuilt with -fstack-usage, which doesn't change
+# the generated code. STACK_LIMIT fails the report on any deeper entry point,
+# STACK_UNKNOWN is the depth assumed for calls into the SDK and C library.
+STACK_LIMIT?=0
+STACK_UNKNOWN?=0
+APP_SU:=$(APP_OBJ:.o=.su)
+
+$(OBJ_DIR)/%.su : %.c
+	mkdir -p $(dir $@)
+	$(CC) $(CFLAGS) -fstack-usage -MMD -c $< -o $(@:.su=.o)
+
+.PHONY: stack_report
+stack_report: $(APP_SU)
+	$(ROOTDIR)/tools/stack_report.py --objdump $(OBJDUMP) -e BoardStart -e AppInit \
+		$(addprefix -s ,$(APP_SRC)) -l $(STACK_LIMIT) -u $(STACK_UNKNOWN) $(APP_OBJ)
+
 clean:
 	rm -f $(OBJ_LIST) *.bin $(PROGRAM_NAME_ELF)
 	rm -rf $(OBJ_DIR) $(RAW_BINARY_DIR)
@@ -18,8 +18,14 @@ LD = $(ARM_TOOLCHAIN_PATH)/bin/arm-none-eabi-ld
 CFLAGS = -Wall -Werror -mcpu=cortex-m4 -mthumb -ffunction-sections -fdata-sections -fomit-frame-pointer -Os -I$(ROOTDIR) -I$(ROOTDIR)/module/include -I. -I$(ROOTDIR)/module/$(MODULE)/include -std=gnu99
 LDSCRIPT =$(ROOTDIR)/module/g2/ldscript/APP.ld
 LDFLAGS = -Wl,-no-wchar-size-warning -Wl,-Map=$(OBJ_DIR)/map.out -Wall -Werror -mcpu=cortex-m4 -mlittle-endian -mthumb -fdata-sections -ffunction-sections -T$(LDSCRIPT) -lm -Wl,--gc-sections -Xlinker -static -specs=nano.specs
+# Floating point printf support, applications formatting with myriota_format.h
+# can leave it out with PRINTF_FLOAT = 0
+PRINTF_FLOAT ?= 1
+ifeq (1, $(PRINTF_FLOAT))
 LDFLAGS += -u _printf_float
+endif
 ifeq (1, $(SCANF_FLOAT))
 LDFLAGS += -u _scanf_float
 endif
 OBJCOPY = $(ARM_TOOLCHAIN_PATH)/bin/arm-none-eabi-objcopy
+OBJDUMP = $(ARM_TOOLCHAIN_PATH)/bin/arm-none-eabi-objdump
@@ -11,5 +11,8 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+APP_SRC+=$(addprefix $(ROOTDIR)/module/g2/sim/, sim_peripherals.c sim_record.c)
+# Charged by sim_peripherals.c
+SIM_WRAP:=ADCGetVoltage ADCGetValue
 
 include $(ROOTDIR)/module/sim/app.mk
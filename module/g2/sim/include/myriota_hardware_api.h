@@ -11,5 +11,44 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#ifndef MYRIOTA_HARDWARE_G2_SIM_API_H
+#define MYRIOTA_HARDWARE_G2_SIM_API_H
+
 #include "module/g2/include/myriota_hardware_api.h"
 #include "module/sim/include/myriota_hardware_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup sim_apis
+/// @{
+
+/// Register map model of an I2C or SPI device on the simulated buses. The
+/// first byte of each transfer selects the register and the following bytes
+/// are read from or written to consecutive registers.
+typedef struct {
+  bool SPI;             ///< on the SPI bus rather than I2C
+  uint16_t I2CAddress;  ///< address on the I2C bus
+  uint8_t AddressMask;  ///< bits of the first byte selecting the register
+  uint8_t SPIReadBit;   ///< bit of the first SPI byte marking a read
+  uint8_t Registers[256];
+  uint8_t Pointer;  ///< register the next read starts at
+} SimDevice;
+
+/// Attaches \p Device to the simulated I2C or SPI bus. There is at most one
+/// SPI device. Returns 0 on success and -1 when too many are attached.
+int SimDeviceAttach(SimDevice *Device);
+
+/// File descriptor UART output goes to when the UART isn't redirected with
+/// SIMUART0, SIMUART1 or SIMLEUART. Optionally defined by the application's
+/// simulation code, standard output otherwise.
+extern const int SimUARTStdout;
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MYRIOTA_HARDWARE_G2_SIM_API_H
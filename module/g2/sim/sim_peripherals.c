@@ -0,0 +1,316 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Simulated GPIO, UART, I2C and SPI peripherals shared by the examples. They
+// are weak so an application's simulation code can still replace any one of
+// them.
+//
+// GPIO inputs follow the gpio events of the SIMTIMELINE file and outputs keep
+// the level they were set to. UARTs use stdin and stdout unless SIMUART0,
+// SIMUART1 or SIMLEUART is set to "pty", to create a pseudo terminal for
+// another program to connect to, to the path of a device, or to
+// "<receive>,<transmit>" paths such as a pair of FIFOs. LEUART data from the
+// timeline is read first. I2C and SPI devices are register map models attached
+// with SimDeviceAttach. All traffic can be recorded to the SIMRECORD file and
+// the input side replayed from a SIMREPLAY file, see sim_record.c.
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "myriota_user_api.h"
+
+#define SIM_PINS 64
+#define SIM_DEVICES 8
+#define SIM_UARTS 3
+
+void SimRecord(const char *Device, const uint8_t *Tx, size_t TxLength,
+               const uint8_t *Rx, size_t RxLength);
+int SimReplay(const char *Device, const uint8_t *Tx, size_t TxLength,
+              uint8_t *Rx, size_t RxLength);
+void SimEnergySample(void);
+
+int __real_ADCGetVoltage(uint8_t PinNum, ADCReference Reference, uint32_t *mV);
+int __real_ADCGetValue(uint8_t PinNum, ADCReference Reference,
+                       uint16_t *Value);
+
+extern const int SimUARTStdout __attribute__((weak));
+
+static struct {
+  bool Output;
+  uint8_t Level;
+} Pins[SIM_PINS];
+
+static SimDevice *Devices[SIM_DEVICES];
+
+typedef struct {
+  const char *Name;
+  const char *Environment;
+  int ReadFd;  // -1 when not initialised
+  int WriteFd;
+} SimUART;
+
+static SimUART UARTs[SIM_UARTS] = {
+    [UART_0] = {"uart0", "SIMUART0", -1, -1},
+    [UART_1] = {"uart1", "SIMUART1", -1, -1},
+    [LEUART] = {"leuart", "SIMLEUART", -1, -1},
+};
+
+__attribute__((weak)) int GPIOSetModeInput(uint8_t PinNum, GPIOPull Pull) {
+  if (PinNum >= SIM_PINS) return -1;
+  Pins[PinNum].Output = false;
+  return 0;
+}
+
+__attribute__((weak)) int GPIOSetModeOutput(uint8_t PinNum) {
+  if (PinNum >= SIM_PINS) return -1;
+  Pins[PinNum].Output = true;
+  return 0;
+}
+
+static int GPIOSet(uint8_t PinNum, uint8_t Level) {
+  char Device[16];
+
+  if (PinNum >= SIM_PINS) return -1;
+  Pins[PinNum].Output = true;
+  if (Pins[PinNum].Level != Level) {
+    Pins[PinNum].Level = Level;
+    snprintf(Device, sizeof(Device), "gpio:%u", PinNum);
+    SimRecord(Device, &Level, 1, NULL, 0);
+  }
+  return 0;
+}
+
+__attribute__((weak)) int GPIOSetHigh(uint8_t PinNum) {
+  return GPIOSet(PinNum, GPIO_HIGH);
+}
+
+__attribute__((weak)) int GPIOSetLow(uint8_t PinNum) {
+  return GPIOSet(PinNum, GPIO_LOW);
+}
+
+__attribute__((weak)) int GPIOGet(uint8_t PinNum) {
+  if (PinNum >= SIM_PINS) return -1;
+  if (Pins[PinNum].Output) return Pins[PinNum].Level;
+  return SimTimelineGPIO(PinNum);
+}
+
+__attribute__((weak)) int GPIOSetWakeupLevel(uint8_t PinNum, GPIOLevel Level) {
+  return PinNum < SIM_PINS ? 0 : -1;
+}
+
+__attribute__((weak)) int GPIODisableWakeup(uint8_t PinNum) {
+  return PinNum < SIM_PINS ? 0 : -1;
+}
+
+static int FileOpen(const char *Path) {
+  // Read and write so opening a FIFO doesn't wait for the other end
+  const int Fd = open(Path, O_RDWR | O_NOCTTY);
+  if (Fd < 0) perror(Path);
+  return Fd;
+}
+
+static int UARTOpen(SimUART *UART) {
+  const char *Path = getenv(UART->Environment);
+  const char *Comma = Path ? strchr(Path, ',') : NULL;
+
+  if (Path == NULL) {
+    UART->ReadFd = STDIN_FILENO;
+    UART->WriteFd = &SimUARTStdout ? SimUARTStdout : STDOUT_FILENO;
+  } else if (strcmp(Path, "pty") == 0) {
+    const int Fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (Fd < 0 || grantpt(Fd) || unlockpt(Fd)) {
+      perror(UART->Environment);
+      return -1;
+    }
+    // Kept open across UARTDeinit so the other end stays connected
+    fprintf(stderr, "%s is %s\n", UART->Name, ptsname(Fd));
+    UART->ReadFd = UART->WriteFd = Fd;
+  } else if (Comma) {
+    char *ReadPath = strndup(Path, Comma - Path);
+    UART->ReadFd = FileOpen(ReadPath);
+    UART->WriteFd = FileOpen(Comma + 1);
+    free(ReadPath);
+  } else {
+    UART->ReadFd = UART->WriteFd = FileOpen(Path);
+  }
+  if (UART->ReadFd < 0 || UART->WriteFd < 0) {
+    UART->ReadFd = UART->WriteFd = -1;
+    return -1;
+  }
+  fcntl(UART->ReadFd, F_SETFL, fcntl(UART->ReadFd, F_GETFL, 0) | O_NONBLOCK);
+  return 0;
+}
+
+__attribute__((weak)) void *UARTInit(UARTInterface UARTNum, uint32_t BaudRate,
+                                     uint32_t Options) {
+  if (UARTNum >= SIM_UARTS) return NULL;
+  SimUART *UART = &UARTs[UARTNum];
+  if (UART->ReadFd < 0 && UARTOpen(UART)) return NULL;
+  return UART;
+}
+
+__attribute__((weak)) void UARTDeinit(void *Handle) {}
+
+__attribute__((weak)) int UARTWrite(void *Handle, const uint8_t *Tx,
+                                    size_t Length) {
+  SimUART *UART = Handle;
+
+  // Keep the order with the application's printf output
+  fflush(stdout);
+  SimRecord(UART->Name, Tx, Length, NULL, 0);
+  while (Length) {
+    const ssize_t n = write(UART->WriteFd, Tx, Length);
+    if (n < 0) return -1;
+    Tx += n;
+    Length -= n;
+  }
+  return 0;
+}
+
+__attribute__((weak)) int UARTRead(void *Handle, uint8_t *Rx, size_t Length) {
+  SimUART *UART = Handle;
+  int Count = 0;
+
+  if (UART == &UARTs[LEUART]) Count = SimTimelineLeuartRead(Rx, Length);
+  if (Count == 0) Count = SimReplay(UART->Name, NULL, 0, Rx, Length);
+  if (Count < 0) {
+    Count = read(UART->ReadFd, Rx, Length);
+    // Nothing to read isn't an error
+    if (Count < 0) Count = 0;
+  }
+  if (Count > 0) SimRecord(UART->Name, NULL, 0, Rx, Count);
+  return Count;
+}
+
+int SimDeviceAttach(SimDevice *Device) {
+  for (int i = 0; i < SIM_DEVICES; i++) {
+    if (Devices[i] == NULL) {
+      Devices[i] = Device;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+static SimDevice *DeviceFind(bool SPI, uint16_t DeviceAddress) {
+  for (int i = 0; i < SIM_DEVICES && Devices[i]; i++) {
+    if (SPI ? Devices[i]->SPI
+            : !Devices[i]->SPI && Devices[i]->I2CAddress == DeviceAddress)
+      return Devices[i];
+  }
+  return NULL;
+}
+
+// Register addresses increment with each byte, as for a burst access
+static void DeviceWrite(SimDevice *Device, const uint8_t *Data, size_t Length) {
+  if (Length == 0) return;
+  Device->Pointer = Data[0] & Device->AddressMask;
+  for (size_t i = 1; i < Length; i++)
+    Device->Registers[Device->Pointer++ & Device->AddressMask] = Data[i];
+}
+
+static void DeviceRead(SimDevice *Device, uint8_t *Rx, size_t Length) {
+  for (size_t i = 0; i < Length; i++)
+    Rx[i] = Device->Registers[(Device->Pointer + i) & Device->AddressMask];
+}
+
+static void I2CDeviceName(char *Device, size_t Size, uint16_t DeviceAddress) {
+  snprintf(Device, Size, "i2c:%02x", DeviceAddress);
+}
+
+__attribute__((weak)) int I2CInit(void) { return 0; }
+
+__attribute__((weak)) int I2CInitEx(uint32_t Option) { return 0; }
+
+__attribute__((weak)) void I2CDeinit(void) {}
+
+__attribute__((weak)) int I2CWrite(uint16_t DeviceAddress,
+                                   const uint8_t *Command,
+                                   size_t CommandLength) {
+  SimDevice *Device = DeviceFind(false, DeviceAddress);
+  char Name[16];
+
+  I2CDeviceName(Name, sizeof(Name), DeviceAddress);
+  SimRecord(Name, Command, CommandLength, NULL, 0);
+  if (Device == NULL) return -1;
+  DeviceWrite(Device, Command, CommandLength);
+  return 0;
+}
+
+__attribute__((weak)) int I2CRead(uint16_t DeviceAddress,
+                                  const uint8_t *Command, size_t CommandLength,
+                                  uint8_t *Rx, size_t RxLength) {
+  SimDevice *Device = DeviceFind(false, DeviceAddress);
+  char Name[16];
+
+  I2CDeviceName(Name, sizeof(Name), DeviceAddress);
+  if (Device) DeviceWrite(Device, Command, CommandLength);
+  if (SimReplay(Name, Command, CommandLength, Rx, RxLength) < 0) {
+    if (Device == NULL) return -1;
+    DeviceRead(Device, Rx, RxLength);
+  }
+  SimRecord(Name, Command, CommandLength, Rx, RxLength);
+  return 0;
+}
+
+__attribute__((weak)) int SPIInit(uint32_t BaudRate) { return 0; }
+
+__attribute__((weak)) void SPIDeinit(void) {}
+
+__attribute__((weak)) int SPIWrite(const uint8_t *Tx, size_t Length) {
+  SimDevice *Device = DeviceFind(true, 0);
+
+  SimRecord("spi", Tx, Length, NULL, 0);
+  if (Device) DeviceWrite(Device, Tx, Length);
+  return 0;
+}
+
+__attribute__((weak)) int SPITransfer(const uint8_t *Tx, uint8_t *Rx,
+                                      size_t Length) {
+  SimDevice *Device = DeviceFind(true, 0);
+
+  if (Length == 0) return 0;
+  // Only the address byte of a register read is sent, the rest are don't
+  // care, so a read may pass a one byte Tx
+  if (Device && (Tx[0] & Device->SPIReadBit)) {
+    if (SimReplay("spi", Tx, 1, Rx, Length) < 0) {
+      Device->Pointer = Tx[0] & Device->AddressMask;
+      Rx[0] = 0;
+      DeviceRead(Device, Rx + 1, Length - 1);
+    }
+    SimRecord("spi", Tx, 1, Rx, Length);
+    return 0;
+  }
+  if (SimReplay("spi", Tx, Length, Rx, Length) < 0) {
+    memset(Rx, 0, Length);
+    if (Device) DeviceWrite(Device, Tx, Length);
+  }
+  SimRecord("spi", Tx, Length, Rx, Length);
+  return 0;
+}
+
+// Samples are charged by the energy model, the application's simulation code
+// or sim.so provides the value
+int __wrap_ADCGetVoltage(uint8_t PinNum, ADCReference Reference,
+                         uint32_t *mV) {
+  SimEnergySample();
+  return __real_ADCGetVoltage(PinNum, Reference, mV);
+}
+
+int __wrap_ADCGetValue(uint8_t PinNum, ADCReference Reference,
+                       uint16_t *Value) {
+  SimEnergySample();
+  return __real_ADCGetValue(PinNum, Reference, Value);
+}
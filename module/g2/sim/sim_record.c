@@ -0,0 +1,157 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Recording and replay of the simulated peripheral traffic. When SIMRECORD
+// names a file every transfer is written to it as a line of
+//
+//   <time> <tick> <device> <sent> <received>
+//
+// where time is TimeGet(), tick is TickGet() in milliseconds, device is for
+// example "i2c:18", "spi", "uart0", "leuart" or "gpio:24", and the data is in
+// hex or "-" when there is none. When SIMREPLAY names such a file the received
+// data of each I2C read, SPI transfer and UART read comes from it, in order
+// per device, instead of from the models. The bytes sent to a bus must match
+// the recording, and UART data isn't received before its recorded time. Once a
+// device's recording runs out its model is used again.
+
+#include <stdlib.h>
+#include <string.h>
+#include "myriota_user_api.h"
+
+typedef struct {
+  int Line;
+  time_t Time;
+  char Device[16];
+  uint8_t *Tx;
+  size_t TxLength;
+  uint8_t *Rx;
+  size_t RxLength;
+  size_t Offset;  // bytes of Rx already read by a UART
+} ReplayEntry;
+
+static FILE *Record;
+static bool ReplayLoaded;
+static const char *ReplayName;
+static ReplayEntry *Replay;
+static size_t ReplayCount;
+
+static void RecordClose(void) { fclose(Record); }
+
+static void HexWrite(FILE *f, const uint8_t *Data, size_t Length) {
+  if (Length == 0) fputc('-', f);
+  for (size_t i = 0; i < Length; i++) fprintf(f, "%02x", Data[i]);
+}
+
+void SimRecord(const char *Device, const uint8_t *Tx, size_t TxLength,
+               const uint8_t *Rx, size_t RxLength) {
+  if (Record == NULL) {
+    const char *Name = getenv("SIMRECORD");
+    if (Name == NULL) return;
+    if ((Record = fopen(Name, "w")) == NULL) {
+      perror(Name);
+      exit(1);
+    }
+    atexit(RecordClose);
+  }
+  fprintf(Record, "%ld %" PRIu32 " %s ", (long)TimeGet(), TickGet(), Device);
+  HexWrite(Record, Tx, TxLength);
+  fputc(' ', Record);
+  HexWrite(Record, Rx, RxLength);
+  fputc('\n', Record);
+}
+
+// Returns the decoded length, or -1 if Text isn't hex
+static int HexRead(const char *Text, uint8_t **Data) {
+  const size_t Length = strlen(Text);
+
+  *Data = NULL;
+  if (strcmp(Text, "-") == 0) return 0;
+  if (Length % 2) return -1;
+  *Data = malloc(Length / 2);
+  for (size_t i = 0; i < Length / 2; i++) {
+    unsigned Byte;
+    if (sscanf(Text + 2 * i, "%2x", &Byte) != 1) return -1;
+    (*Data)[i] = Byte;
+  }
+  return Length / 2;
+}
+
+static void ReplayLoad(void) {
+  char Line[1024];
+  int LineNumber = 0;
+  FILE *f;
+
+  ReplayLoaded = true;
+  if ((ReplayName = getenv("SIMREPLAY")) == NULL) return;
+  if ((f = fopen(ReplayName, "r")) == NULL) {
+    perror(ReplayName);
+    exit(1);
+  }
+  while (fgets(Line, sizeof(Line), f)) {
+    char Tx[sizeof(Line)], Rx[sizeof(Line)];
+    ReplayEntry Entry = {.Line = ++LineNumber};
+    long Time;
+    int TxLength, RxLength;
+
+    if (sscanf(Line, "%ld %*u %15s %s %s", &Time, Entry.Device, Tx, Rx) != 4 ||
+        (TxLength = HexRead(Tx, &Entry.Tx)) < 0 ||
+        (RxLength = HexRead(Rx, &Entry.Rx)) < 0) {
+      fprintf(stderr, "%s:%d: invalid line\n", ReplayName, LineNumber);
+      exit(1);
+    }
+    // Only received data is replayed
+    if (RxLength == 0) {
+      free(Entry.Tx);
+      continue;
+    }
+    Entry.Time = Time;
+    Entry.TxLength = TxLength;
+    Entry.RxLength = RxLength;
+    Replay = realloc(Replay, (ReplayCount + 1) * sizeof(ReplayEntry));
+    Replay[ReplayCount++] = Entry;
+  }
+  fclose(f);
+}
+
+int SimReplay(const char *Device, const uint8_t *Tx, size_t TxLength,
+              uint8_t *Rx, size_t RxLength) {
+  ReplayEntry *Entry = NULL;
+
+  if (!ReplayLoaded) ReplayLoad();
+  for (size_t i = 0; i < ReplayCount && Entry == NULL; i++) {
+    if (Replay[i].Offset < Replay[i].RxLength &&
+        strcmp(Replay[i].Device, Device) == 0)
+      Entry = &Replay[i];
+  }
+  if (Entry == NULL) return -1;
+
+  // UART reads take whatever has been received by now
+  if (TxLength == 0) {
+    if (Entry->Time > TimeGet()) return 0;
+    const size_t Available = Entry->RxLength - Entry->Offset;
+    if (RxLength > Available) RxLength = Available;
+    memcpy(Rx, Entry->Rx + Entry->Offset, RxLength);
+    Entry->Offset += RxLength;
+    return RxLength;
+  }
+
+  if (TxLength != Entry->TxLength || memcmp(Tx, Entry->Tx, TxLength) ||
+      RxLength != Entry->RxLength) {
+    fprintf(stderr, "%s:%d: %s transfer differs from the recording\n",
+            ReplayName, Entry->Line, Device);
+    exit(1);
+  }
+  memcpy(Rx, Entry->Rx, RxLength);
+  Entry->Offset = RxLength;
+  return RxLength;
+}
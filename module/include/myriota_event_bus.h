@@ -0,0 +1,86 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Delivery of the GPIO wakeup, pulse counter, LEUART and received message
+// events to any number of handlers. Build module/event_bus.c with the
+// application, APP_SRC += $(ROOTDIR)/module/event_bus.c, list the handlers in
+// the application's EventSubscribers table and call EventBusStart from
+// AppInit:
+//
+//   EventSubscriber EventSubscribers[] = {
+//       {.Source = EVENT_GPIO, .Callback = OnButton, .Debounce = 1},
+//       {.Source = EVENT_GPIO, .Callback = OnVibration, .Priority = 1},
+//       {.Source = EVENT_DOWNLINK, .Callback = OnCommand},
+//       EVENT_SUBSCRIBERS_END};
+//
+// Each event source with subscribers takes one scheduled job.
+
+#ifndef MYRIOTA_EVENT_BUS_H
+#define MYRIOTA_EVENT_BUS_H
+
+#include <stdbool.h>
+#include "myriota_user_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @defgroup Event_bus Event bus
+/// @{
+
+typedef enum {
+  EVENT_GPIO,           ///< OnGPIOWakeup
+  EVENT_PULSE_COUNTER,  ///< OnPulseCounterEvent
+  EVENT_LEUART,         ///< OnLeuartReceive
+  EVENT_DOWNLINK,       ///< OnReceiveMessage
+  EVENT_SOURCES
+} EventSource;
+
+typedef struct {
+  EventSource Source;
+  time_t Time;          ///< Time the event was delivered
+  const uint8_t *Data;  ///< Received message of EVENT_DOWNLINK, else NULL
+  int Size;             ///< Size of Data
+} Event;
+
+/// Handles \p Evt. Return true to stop delivering it to the subscribers of
+/// lower priority.
+typedef bool (*EventCallback)(const Event *Evt);
+
+typedef struct {
+  EventSource Source;
+  EventCallback Callback;
+  uint8_t Priority;   ///< Delivered to priority 0 first, then in table order
+  uint32_t Debounce;  ///< Seconds after a delivery that events are ignored
+  // Private
+  time_t LastDelivery;
+} EventSubscriber;
+
+/// Ends the EventSubscribers table.
+#define EVENT_SUBSCRIBERS_END \
+  { .Callback = NULL }
+
+/// Subscribers defined by the application, ending with EVENT_SUBSCRIBERS_END.
+extern EventSubscriber EventSubscribers[];
+
+/// Schedules a job for each event source with subscribers.
+/// Returns 0 if succeeded and -1 if the maximum number of jobs is reached.
+int EventBusStart(void);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MYRIOTA_EVENT_BUS_H
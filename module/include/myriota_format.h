@@ -0,0 +1,89 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Integer only formatting of fixed point values, so applications can print
+// coordinates, voltages and currents without linking the floating point
+// printf. Build with PRINTF_FLOAT = 0 to leave it out.
+
+#ifndef MYRIOTA_FORMAT_H
+#define MYRIOTA_FORMAT_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @defgroup Fixed_format Fixed point formatting
+/// @{
+
+/// Buffer size large enough for any value formatted by FormatFixed.
+#define FIXED_STR_SIZE 13
+
+/// Formats \p Value divided by 10 to the power of \p Decimals into \p Buf,
+/// e.g. FormatFixed(Buf, sizeof(Buf), -891234567, 7) gives "-89.1234567".
+/// \p Decimals is at most 9. Like snprintf the output is truncated to
+/// \p BufSize and the return value is the length of the full result.
+static inline int FormatFixed(char *Buf, size_t BufSize, int32_t Value,
+                              unsigned Decimals) {
+  char Digits[FIXED_STR_SIZE];
+  char *p = Digits + sizeof(Digits);
+  uint32_t Magnitude = Value < 0 ? -(uint32_t)Value : (uint32_t)Value;
+  unsigned Count = 0;
+
+  if (Decimals > 9) Decimals = 9;
+  // Digits are produced backwards, with at least one before the point
+  do {
+    *--p = '0' + Magnitude % 10;
+    Magnitude /= 10;
+    if (++Count == Decimals) *--p = '.';
+  } while (Magnitude || Count <= Decimals);
+  if (Value < 0) *--p = '-';
+
+  const int Length = Digits + sizeof(Digits) - p;
+  if (BufSize) {
+    size_t n = (size_t)Length < BufSize - 1 ? (size_t)Length : BufSize - 1;
+    for (size_t i = 0; i < n; i++) Buf[i] = p[i];
+    Buf[n] = '\0';
+  }
+  return Length;
+}
+
+/// Same as FormatFixed but returns \p Buf, for use as a printf argument.
+static inline const char *FixedStr(char *Buf, size_t BufSize, int32_t Value,
+                                   unsigned Decimals) {
+  FormatFixed(Buf, BufSize, Value, Decimals);
+  return Buf;
+}
+
+/// Formats a fixed point value into a temporary buffer which lasts until the
+/// end of the enclosing block, e.g.
+/// printf("%s V\n", FIXED_STR(mV, 3));
+#define FIXED_STR(Value, Decimals) \
+  FixedStr((char[FIXED_STR_SIZE]){0}, FIXED_STR_SIZE, (Value), (Decimals))
+
+/// Formats a 1e7 scaled latitude or longitude, as returned by LocationGet,
+/// in degrees.
+#define COORD_STR(Value) FIXED_STR(Value, 7)
+
+/// Formats a value in thousandths in whole units, e.g. mV in V or uA in mA.
+#define MILLI_STR(Value) FIXED_STR(Value, 3)
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MYRIOTA_FORMAT_H
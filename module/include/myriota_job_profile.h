@@ -0,0 +1,74 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Per-job scheduler profiling. Building with JOB_PROFILE = 1 redirects the
+// application's ScheduleJob calls through module/job_profile.c, which counts
+// the runs, run time and wakeups of each job and logs them every
+// JOB_PROFILE_INTERVAL seconds. tools/log-util.py decodes the records as "Job
+// profile". Without JOB_PROFILE the functions below do nothing.
+
+#ifndef MYRIOTA_JOB_PROFILE_H
+#define MYRIOTA_JOB_PROFILE_H
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @defgroup Job_profile Job profiling
+/// @{
+
+/// User error code the profile records are logged with, 0 - 127. Set with
+/// JOB_PROFILE_LOG_CODE = N if the application already logs with 126.
+#ifndef JOB_PROFILE_LOG_CODE
+#define JOB_PROFILE_LOG_CODE 126
+#endif
+
+/// Maximum number of jobs profiled, as a record must fit in one LogAdd.
+/// Jobs scheduled once all are in use run without being profiled.
+#define JOB_PROFILE_MAX_JOBS 15
+
+/// Profile of one job as logged, in little endian.
+typedef struct __attribute__((packed)) {
+  uint32_t Job;         ///< Address of the job function, low 32 bits in sim
+  uint32_t Runs;        ///< Number of runs
+  uint32_t TotalTicks;  ///< Run time of all runs in ticks (milliseconds)
+  uint16_t MaxTicks;    ///< Longest run, saturates at 0xFFFF
+  uint16_t Wakeups;     ///< Runs that woke the module, saturates at 0xFFFF
+} JobProfile;
+
+#ifdef JOB_PROFILE
+
+/// Logs the profile of every job since the last log and clears it. This is
+/// done automatically every JOB_PROFILE_INTERVAL seconds, if not 0.
+/// Returns 0 if logging succeeds and -1 if logging fails.
+int JobProfileLog(void);
+
+/// Clears the profile of every job without logging it.
+void JobProfileReset(void);
+
+#else
+
+static inline int JobProfileLog(void) { return 0; }
+static inline void JobProfileReset(void) {}
+
+#endif
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MYRIOTA_JOB_PROFILE_H
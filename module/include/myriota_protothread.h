@@ -0,0 +1,102 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Stackless protothreads on top of ScheduleJob, so a job can wait by returning
+// to the scheduler, which sleeps or runs other jobs, and carry on from where it
+// left off at its next run:
+//
+//   static time_t ReadJob(void) {
+//     static Protothread pt;
+//     PT_BEGIN(&pt);
+//     GPIOSetHigh(SENSOR_ENABLE);
+//     PT_SLEEP_MS(&pt, 1500);
+//     ADCGetVoltage(SENSOR_ADC, ADC_REF_2V5, &mv);
+//     GPIOSetLow(SENSOR_ENABLE);
+//     PT_END(&pt, HoursFromNow(8));
+//   }
+//
+// Local variables don't keep their values across a wait, make them static.
+// A switch statement can't contain a wait, as waits are case labels of the
+// switch in PT_BEGIN. While waiting the job runs at the time it yielded for,
+// not on the event it was scheduled on before.
+
+#ifndef MYRIOTA_PROTOTHREAD_H
+#define MYRIOTA_PROTOTHREAD_H
+
+#include "myriota_user_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @defgroup Protothread Protothreads
+/// @{
+
+/// Waits shorter than this are done with Delay, as the scheduler runs jobs
+/// on whole seconds.
+#ifndef PT_SLEEP_MIN_MS
+#define PT_SLEEP_MIN_MS 1000
+#endif
+
+/// State of a protothread, zero to start from PT_BEGIN.
+typedef struct {
+  int Line;  ///< Line to resume at
+} Protothread;
+
+/// Starts the body of the job of protothread \p pt.
+#define PT_BEGIN(pt)    \
+  switch ((pt)->Line) { \
+    case 0:
+
+/// Returns \p Next from the job, any time accepted by ScheduleJob such as
+/// SecondsFromNow(10) or OnLeuartReceive(), and carries on from here when the
+/// job next runs.
+#define PT_YIELD_UNTIL(pt, Next) \
+  do {                           \
+    (pt)->Line = __LINE__;       \
+    return (Next);               \
+    case __LINE__:;              \
+  } while (0)
+
+/// Waits at least \p mSec milliseconds. Waits of PT_SLEEP_MIN_MS or more
+/// yield for the time rounded up to whole seconds, plus one second as
+/// SecondsFromNow counts from the start of the current second.
+#define PT_SLEEP_MS(pt, mSec)                                        \
+  do {                                                               \
+    if ((mSec) < PT_SLEEP_MIN_MS)                                    \
+      Delay(mSec);                                                   \
+    else                                                             \
+      PT_YIELD_UNTIL(pt, SecondsFromNow(((mSec) + 999) / 1000 + 1)); \
+  } while (0)
+
+/// Yields until \p Condition is true, checking it at each \p Next, e.g.
+/// PT_WAIT_UNTIL(&pt, UARTRead(Handle, &c, 1) == 1, OnLeuartReceive()).
+/// \p Next is either an event or a time, so a wait on an event can't time
+/// out.
+#define PT_WAIT_UNTIL(pt, Condition, Next) \
+  while (!(Condition)) PT_YIELD_UNTIL(pt, Next)
+
+/// Ends the body of the job, which returns \p Next and starts again from
+/// PT_BEGIN at its next run.
+#define PT_END(pt, Next) \
+  }                      \
+  (pt)->Line = 0;        \
+  return (Next)
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MYRIOTA_PROTOTHREAD_H
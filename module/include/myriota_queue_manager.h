@@ -0,0 +1,81 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Message scheduling with a priority and a time to live, so a full queue
+// drops the messages the application values least instead of any message.
+// Build module/queue_manager.c with the application, APP_SRC +=
+// $(ROOTDIR)/module/queue_manager.c, and schedule messages with QueueMessage
+// instead of ScheduleMessage.
+
+#ifndef MYRIOTA_QUEUE_MANAGER_H
+#define MYRIOTA_QUEUE_MANAGER_H
+
+#include "myriota_user_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @defgroup Queue_manager Message queue manager
+/// @{
+
+/// Maximum number of messages tracked and of queue entries read with
+/// MessageQueueStatus, at least MessageSlotsMax. If it is less, messages that
+/// left the queue are only forgotten once the queue holds fewer than this.
+#ifndef QUEUE_MANAGER_MESSAGES
+#define QUEUE_MANAGER_MESSAGES 32
+#endif
+
+/// Which pending message to delete to make room for a new one.
+typedef enum {
+  QUEUE_EVICT_LOWEST_PRIORITY,  ///< Lowest priority below the new message's
+  QUEUE_EVICT_OLDEST,  ///< Oldest with the new message's priority or below
+} QueueEvictPolicy;
+
+/// Queue occupancy and what the manager did to it.
+typedef struct {
+  int SlotsMax;         ///< MessageSlotsMax
+  int SlotsFree;        ///< MessageSlotsFree
+  size_t BytesFree;     ///< MessageBytesFree
+  int Pending;          ///< Messages waiting to be transmitted
+  int Ongoing;          ///< Messages being transmitted
+  uint32_t Scheduled;   ///< Messages scheduled by QueueMessage
+  uint32_t Reclaimed;   ///< Transmitted or expired messages deleted for room
+  uint32_t TimedOut;    ///< Messages deleted as their time to live passed
+  uint32_t Evicted;     ///< Pending messages deleted for a new message
+  uint32_t Rejected;    ///< New messages not scheduled for lack of room
+} QueueMetrics;
+
+/// Sets the eviction policy, QUEUE_EVICT_LOWEST_PRIORITY by default.
+void QueuePolicySet(QueueEvictPolicy Policy);
+
+/// Schedules \p Message of \p MessageSize bytes with \p Priority, higher
+/// values are kept longer, and deletes it if not transmitted within \p TTL
+/// seconds, or never if 0. Room is made by deleting transmitted and expired
+/// messages first and then by the eviction policy. Messages scheduled with
+/// ScheduleMessage directly aren't deleted.
+/// Returns the message ID (>=0) or -1 if there's no room for the message.
+int QueueMessage(const uint8_t *Message, size_t MessageSize, uint8_t Priority,
+                 uint32_t TTL);
+
+/// Deletes the messages whose time to live has passed and fills in
+/// \p Metrics.
+void QueueMetricsGet(QueueMetrics *Metrics);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MYRIOTA_QUEUE_MANAGER_H
@@ -0,0 +1,68 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Packing of small records into fewer, fuller messages. Build
+// module/record_packer.c with the application, APP_SRC +=
+// $(ROOTDIR)/module/record_packer.c, call PackerStart from AppInit and add
+// records with PackerAdd instead of scheduling a message for each.
+//
+// A message is a sequence of records, each a type byte, a length byte and
+// that many bytes of data. A type of 0 ends the message early, e.g. at
+// padding. tools/unpack_records.py splits messages back into records.
+
+#ifndef MYRIOTA_RECORD_PACKER_H
+#define MYRIOTA_RECORD_PACKER_H
+
+#include "myriota_user_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @defgroup Record_packer Record packer
+/// @{
+
+/// Bytes of records held before they're scheduled, the largest message.
+#ifndef RECORD_PACKER_SIZE
+#define RECORD_PACKER_SIZE 128
+#endif
+
+/// Bytes a record takes in a message besides its data.
+#define RECORD_HEADER_SIZE 2
+
+/// Starts packing. Records are scheduled as one message once they reach
+/// \p TargetSize bytes, at most RECORD_PACKER_SIZE, or just before the next
+/// satellite transmit opportunity, but no later than \p MaxAge seconds after
+/// the first record was added. Messages are only scheduled if
+/// MessageBytesFree and MessageSlotsFree have room for them, with the rest
+/// of the records kept for the next message.
+/// Returns 0 if succeeded and -1 if the packer job couldn't be scheduled.
+int PackerStart(size_t TargetSize, uint32_t MaxAge);
+
+/// Adds a record of \p Type, 1 - 255, with \p Length bytes of \p Data.
+/// Returns 0 if succeeded and -1 if the record is invalid or there's no
+/// room for it as the queue is full.
+int PackerAdd(uint8_t Type, const void *Data, uint8_t Length);
+
+/// Schedules the records added so far as a message now.
+/// Returns the message ID (>=0), or -1 if there are no records or the queue
+/// has no room for them.
+int PackerFlush(void);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MYRIOTA_RECORD_PACKER_H
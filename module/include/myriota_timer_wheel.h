@@ -0,0 +1,77 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Any number of logical timers run from a single scheduled job. Build
+// module/timer_wheel.c with the application, APP_SRC +=
+// $(ROOTDIR)/module/timer_wheel.c, and declare the timers statically:
+//
+//   static void Heartbeat(Timer *t) { ... }
+//   static Timer HeartbeatTimer = {.Callback = Heartbeat,
+//                                  .Period = 3600,
+//                                  .Slack = 300};
+//   ...
+//   TimerStart(&HeartbeatTimer, 3600);
+//
+// A timer with a slack may run up to that many seconds late, at a time shared
+// with other timers where possible, so several timers take one wakeup.
+
+#ifndef MYRIOTA_TIMER_WHEEL_H
+#define MYRIOTA_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include "myriota_user_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @defgroup Timer_wheel Timer wheel
+/// @{
+
+typedef struct Timer Timer;
+
+/// Called when the timer expires. A timer can be started or stopped from
+/// its own or any other callback.
+typedef void (*TimerCallback)(Timer *Tmr);
+
+/// A logical timer. Set the fields before TimerStart and leave the rest
+/// zero.
+struct Timer {
+  TimerCallback Callback;
+  uint32_t Period;  ///< Seconds between runs, 0 to run once
+  uint32_t Slack;   ///< Seconds the timer may run late to share a wakeup
+  void *Context;    ///< For the application's use
+  // Private
+  time_t Deadline;
+  time_t Expiry;
+  Timer *Next;
+  Timer **Link;
+};
+
+/// Starts or restarts \p Tmr to first expire in \p Seconds.
+/// Returns 0 if succeeded and -1 if the timer job couldn't be scheduled.
+int TimerStart(Timer *Tmr, uint32_t Seconds);
+
+/// Stops \p Tmr, which does nothing if it isn't running.
+void TimerStop(Timer *Tmr);
+
+/// Returns true if \p Tmr is running.
+bool TimerActive(const Timer *Tmr);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MYRIOTA_TIMER_WHEEL_H
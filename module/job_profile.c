@@ -0,0 +1,109 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Per-job scheduler profiling, built with JOB_PROFILE = 1. The application's
+// ScheduleJob calls are redirected here with the linker's --wrap option and
+// each job is scheduled through a stub of its own, which times the run with
+// TickGet. A run counts as a wakeup unless another job finished within the
+// same second, so jobs running back to back share the wakeup of the first.
+
+#include "myriota_job_profile.h"
+#include "myriota_user_api.h"
+
+#ifndef JOB_PROFILE_INTERVAL
+#define JOB_PROFILE_INTERVAL 86400
+#endif
+
+int __real_ScheduleJob(ScheduledJob Job, time_t Time);
+
+static ScheduledJob Jobs[JOB_PROFILE_MAX_JOBS];
+static JobProfile Profiles[JOB_PROFILE_MAX_JOBS];
+static int JobCount;
+static time_t LastRunEnd;
+static time_t NextLog;
+
+static time_t JobRun(int Slot) {
+  JobProfile *Profile = &Profiles[Slot];
+  const uint32_t Start = TickGet();
+  time_t Next;
+
+  if (TimeGet() != LastRunEnd && Profile->Wakeups < UINT16_MAX)
+    Profile->Wakeups++;
+  Next = Jobs[Slot]();
+  const uint32_t Ticks = TickGet() - Start;
+  LastRunEnd = TimeGet();
+
+  Profile->Runs++;
+  Profile->TotalTicks += Ticks;
+  if (Ticks > Profile->MaxTicks)
+    Profile->MaxTicks = Ticks < UINT16_MAX ? Ticks : UINT16_MAX;
+
+  if (JOB_PROFILE_INTERVAL) {
+    if (NextLog == 0) NextLog = LastRunEnd + JOB_PROFILE_INTERVAL;
+    if (LastRunEnd >= NextLog) {
+      JobProfileLog();
+      NextLog = LastRunEnd + JOB_PROFILE_INTERVAL;
+    }
+  }
+  return Next;
+}
+
+#define JOB_STUB(n) \
+  static time_t JobStub##n(void) { return JobRun(n); }
+
+JOB_STUB(0)
+JOB_STUB(1)
+JOB_STUB(2)
+JOB_STUB(3)
+JOB_STUB(4)
+JOB_STUB(5)
+JOB_STUB(6)
+JOB_STUB(7)
+JOB_STUB(8)
+JOB_STUB(9)
+JOB_STUB(10)
+JOB_STUB(11)
+JOB_STUB(12)
+JOB_STUB(13)
+JOB_STUB(14)
+
+static const ScheduledJob Stubs[JOB_PROFILE_MAX_JOBS] = {
+    JobStub0,  JobStub1,  JobStub2,  JobStub3, JobStub4,
+    JobStub5,  JobStub6,  JobStub7,  JobStub8, JobStub9,
+    JobStub10, JobStub11, JobStub12, JobStub13, JobStub14,
+};
+
+int __wrap_ScheduleJob(ScheduledJob Job, time_t Time) {
+  int Slot = 0;
+
+  while (Slot < JobCount && Jobs[Slot] != Job) Slot++;
+  if (Slot == JobCount) {
+    if (JobCount == JOB_PROFILE_MAX_JOBS) return __real_ScheduleJob(Job, Time);
+    Jobs[Slot] = Job;
+    Profiles[Slot].Job = (uintptr_t)Job;
+    JobCount++;
+  }
+  return __real_ScheduleJob(Stubs[Slot], Time);
+}
+
+void JobProfileReset(void) {
+  for (int i = 0; i < JobCount; i++)
+    Profiles[i] = (JobProfile){.Job = (uintptr_t)Jobs[i]};
+}
+
+int JobProfileLog(void) {
+  const int Result =
+      LogAdd(JOB_PROFILE_LOG_CODE, Profiles, JobCount * sizeof(JobProfile));
+  JobProfileReset();
+  return Result;
+}
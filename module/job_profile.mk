@@ -0,0 +1,26 @@
+# Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Per-job run count, run time and wakeups, logged every JOB_PROFILE_INTERVAL
+# seconds (0 to only log on JobProfileLog), see myriota_job_profile.h
+JOB_PROFILE?=0
+JOB_PROFILE_INTERVAL?=86400
+# User error code of the profile records, log-util.py --job-profile-code
+JOB_PROFILE_LOG_CODE?=126
+
+ifeq (1, $(JOB_PROFILE))
+CFLAGS+=-DJOB_PROFILE -DJOB_PROFILE_INTERVAL=$(JOB_PROFILE_INTERVAL)
+CFLAGS+=-DJOB_PROFILE_LOG_CODE=$(JOB_PROFILE_LOG_CODE)
+LDFLAGS+=-Wl,--wrap=ScheduleJob
+APP_SRC+=$(ROOTDIR)/module/job_profile.c
+endif
@@ -0,0 +1,181 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Priority and time to live of the messages scheduled by QueueMessage, kept
+// by message ID. The transmit status of the tracked messages is read with
+// MessageQueueStatus before each decision, and messages no longer in the
+// queue are forgotten. Room is made before ScheduleMessage is called, so it
+// never has to replace a message itself, and only once the messages to delete
+// are known to free enough of it.
+
+#include "myriota_queue_manager.h"
+
+typedef struct {
+  bool Used;
+  bool Victim;  // to be deleted by QueueMakeRoom
+  uint16_t Id;
+  uint16_t Size;
+  uint8_t Priority;
+  MessageTransmitStatus_t Status;
+  time_t Queued;
+  time_t Expiry;  // 0 for never
+} QueueEntry;
+
+static QueueEntry Entries[QUEUE_MANAGER_MESSAGES];
+static MessageStatus_t QueueStatus[QUEUE_MANAGER_MESSAGES];
+static QueueEvictPolicy Policy = QUEUE_EVICT_LOWEST_PRIORITY;
+static QueueMetrics Counters;
+
+void QueuePolicySet(QueueEvictPolicy NewPolicy) { Policy = NewPolicy; }
+
+// The entry is kept if the message couldn't be deleted, and forgotten by
+// QueueRefresh once it has left the queue
+static void QueueDelete(QueueEntry *Entry, uint32_t *Counter) {
+  if (MessageQueueDelete(Entry->Id) != 0) return;
+  (*Counter)++;
+  Entry->Used = false;
+}
+
+// Updates the status of the tracked messages and deletes the pending ones
+// past their time to live
+static void QueueRefresh(void) {
+  const int Count = MessageQueueStatus(QueueStatus, QUEUE_MANAGER_MESSAGES);
+  const time_t Now = TimeGet();
+  // A full status array may have left out messages still in the queue, if
+  // QUEUE_MANAGER_MESSAGES is below MessageSlotsMax
+  const bool Complete = Count >= 0 && Count < QUEUE_MANAGER_MESSAGES;
+
+  for (int i = 0; i < QUEUE_MANAGER_MESSAGES; i++) {
+    QueueEntry *Entry = &Entries[i];
+    int j = 0;
+    if (!Entry->Used) continue;
+    while (j < Count && QueueStatus[j].id != Entry->Id) j++;
+    if (j >= Count) {
+      if (Complete) Entry->Used = false;
+      continue;
+    }
+    Entry->Status = QueueStatus[j].status;
+    if (Entry->Status == TRANSMIT_PENDING && Entry->Expiry &&
+        Now >= Entry->Expiry)
+      QueueDelete(Entry, &Counters.TimedOut);
+  }
+}
+
+static bool QueueRoom(int Slots, size_t Bytes, size_t MessageSize) {
+  return Slots > 0 && Bytes >= MessageSize;
+}
+
+// The pending message to delete for a message of Priority, or NULL
+static QueueEntry *QueueVictim(uint8_t Priority) {
+  QueueEntry *Victim = NULL;
+
+  for (int i = 0; i < QUEUE_MANAGER_MESSAGES; i++) {
+    QueueEntry *Entry = &Entries[i];
+    if (!Entry->Used || Entry->Victim || Entry->Status != TRANSMIT_PENDING)
+      continue;
+    if (Policy == QUEUE_EVICT_OLDEST) {
+      if (Entry->Priority > Priority) continue;
+      if (Victim == NULL || Entry->Queued < Victim->Queued ||
+          (Entry->Queued == Victim->Queued &&
+           Entry->Priority < Victim->Priority))
+        Victim = Entry;
+    } else {
+      if (Entry->Priority >= Priority) continue;
+      if (Victim == NULL || Entry->Priority < Victim->Priority ||
+          (Entry->Priority == Victim->Priority &&
+           Entry->Queued < Victim->Queued))
+        Victim = Entry;
+    }
+  }
+  return Victim;
+}
+
+static bool QueueMakeRoom(size_t MessageSize, uint8_t Priority) {
+  int Slots = MessageSlotsFree();
+  size_t Bytes = MessageBytesFree();
+
+  for (int i = 0; i < QUEUE_MANAGER_MESSAGES; i++) Entries[i].Victim = false;
+
+  // Messages already transmitted or expired go first
+  for (int i = 0;
+       i < QUEUE_MANAGER_MESSAGES && !QueueRoom(Slots, Bytes, MessageSize);
+       i++) {
+    QueueEntry *Entry = &Entries[i];
+    if (Entry->Used && (Entry->Status == TRANSMIT_COMPLETE ||
+                        Entry->Status == TRANSMIT_EXPIRED)) {
+      Entry->Victim = true;
+      Slots++;
+      Bytes += Entry->Size;
+    }
+  }
+  while (!QueueRoom(Slots, Bytes, MessageSize)) {
+    QueueEntry *Victim = QueueVictim(Priority);
+    if (Victim == NULL) return false;
+    Victim->Victim = true;
+    Slots++;
+    Bytes += Victim->Size;
+  }
+
+  for (int i = 0; i < QUEUE_MANAGER_MESSAGES; i++) {
+    QueueEntry *Entry = &Entries[i];
+    if (!Entry->Victim) continue;
+    if (Entry->Status == TRANSMIT_PENDING)
+      QueueDelete(Entry, &Counters.Evicted);
+    else
+      QueueDelete(Entry, &Counters.Reclaimed);
+  }
+  return QueueRoom(MessageSlotsFree(), MessageBytesFree(), MessageSize);
+}
+
+int QueueMessage(const uint8_t *Message, size_t MessageSize, uint8_t Priority,
+                 uint32_t TTL) {
+  QueueEntry *Entry = &Entries[0];
+  int Id;
+
+  QueueRefresh();
+  if (!QueueMakeRoom(MessageSize, Priority) ||
+      (Id = ScheduleMessage(Message, MessageSize)) < 0) {
+    Counters.Rejected++;
+    return -1;
+  }
+  Counters.Scheduled++;
+
+  // A free entry, or else stop tracking the oldest message
+  for (int i = 0; i < QUEUE_MANAGER_MESSAGES && Entry->Used; i++) {
+    if (!Entries[i].Used || Entries[i].Queued < Entry->Queued)
+      Entry = &Entries[i];
+  }
+  *Entry = (QueueEntry){.Used = true,
+                        .Id = Id,
+                        .Size = MessageSize,
+                        .Priority = Priority,
+                        .Status = TRANSMIT_PENDING,
+                        .Queued = TimeGet(),
+                        .Expiry = TTL ? TimeGet() + TTL : 0};
+  return Id;
+}
+
+void QueueMetricsGet(QueueMetrics *Metrics) {
+  QueueRefresh();
+
+  const int Count = MessageQueueStatus(QueueStatus, QUEUE_MANAGER_MESSAGES);
+
+  *Metrics = Counters;
+  Metrics->SlotsMax = MessageSlotsMax();
+  Metrics->SlotsFree = MessageSlotsFree();
+  Metrics->BytesFree = MessageBytesFree();
+  for (int i = 0; i < Count; i++) {
+    if (QueueStatus[i].status == TRANSMIT_PENDING) Metrics->Pending++;
+    if (QueueStatus[i].status == TRANSMIT_ONGOING) Metrics->Ongoing++;
+  }
+}
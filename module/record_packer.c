@@ -0,0 +1,104 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Records are appended to a RAM buffer and scheduled from its start, whole
+// records only. The packer job runs before the next satellite transmit
+// opportunity within the maximum age of the oldest record, and retries every
+// PACKER_RETRY_INTERVAL while the queue has no room.
+
+#include <string.h>
+#include "myriota_record_packer.h"
+
+#define PACKER_RETRY_INTERVAL (15 * 60)
+
+static uint8_t Buffer[RECORD_PACKER_SIZE];
+static size_t Used;
+static size_t TargetSize = RECORD_PACKER_SIZE;
+static uint32_t MaxAge;
+static time_t Oldest;  // time the first record in Buffer was added, or before
+static bool Running;   // in PackerJob, which reschedules itself on return
+
+static time_t PackerNext(void) {
+  const time_t Now = TimeGet();
+  const time_t Deadline = Oldest + MaxAge;
+
+  if (Used == 0) return Never();
+  if (Deadline <= Now) return Now;
+  return BeforeSatelliteTransmit(Now, Deadline);
+}
+
+static time_t PackerJob(void) {
+  Running = true;
+  PackerFlush();
+  Running = false;
+
+  // Records left didn't fit in the queue
+  return Used ? SecondsFromNow(PACKER_RETRY_INTERVAL) : Never();
+}
+
+static int PackerSchedule(void) {
+  return Running ? 0 : ScheduleJob(PackerJob, PackerNext());
+}
+
+int PackerStart(size_t NewTargetSize, uint32_t NewMaxAge) {
+  TargetSize =
+      NewTargetSize < RECORD_PACKER_SIZE ? NewTargetSize : RECORD_PACKER_SIZE;
+  MaxAge = NewMaxAge;
+  return PackerSchedule();
+}
+
+// Length of the whole records at the start of Buffer that fit in Size
+static size_t PackerFitting(size_t Size) {
+  size_t Length = 0;
+
+  while (Length < Used) {
+    const size_t Next = Length + RECORD_HEADER_SIZE + Buffer[Length + 1];
+    if (Next > Size) break;
+    Length = Next;
+  }
+  return Length;
+}
+
+int PackerFlush(void) {
+  const size_t Length =
+      MessageSlotsFree() > 0 ? PackerFitting(MessageBytesFree()) : 0;
+  int Id;
+
+  if (Length == 0 || (Id = ScheduleMessage(Buffer, Length)) < 0) return -1;
+  memmove(Buffer, Buffer + Length, Used - Length);
+  Used -= Length;
+  // Records aren't timed one by one, so those left keep the age of the
+  // first, which may send them early but never after MaxAge
+  PackerSchedule();
+  return Id;
+}
+
+int PackerAdd(uint8_t Type, const void *Data, uint8_t Length) {
+  const size_t Size = RECORD_HEADER_SIZE + Length;
+
+  if (Type == 0 || Size > TargetSize) return -1;
+  if (Used + Size > TargetSize) PackerFlush();
+  if (Used + Size > RECORD_PACKER_SIZE) return -1;
+
+  if (Used == 0) Oldest = TimeGet();
+  Buffer[Used] = Type;
+  Buffer[Used + 1] = Length;
+  memcpy(&Buffer[Used + RECORD_HEADER_SIZE], Data, Length);
+  Used += Size;
+
+  if (Used >= TargetSize)
+    PackerFlush();
+  else if (Used == Size)
+    PackerSchedule();
+  return 0;
+}
@@ -15,14 +15,17 @@ NETWORK_INFO_DIR:=network_info
 OBJ_DIR:=obj
 
 include $(ROOTDIR)/module/sim/flags.mk
+include $(ROOTDIR)/module/job_profile.mk
 include $(ROOTDIR)/module/builtin.mk
 
 $(shell mkdir -p $(OBJ_DIR))
 
 LIB_DIR:=$(ROOTDIR)/module/sim
 LIBS:=$(LIB_DIR)/sim.so
+SIM_SRC:=sim_duration.c sim_stats.c sim_timeline.c sim_energy.c
+APP_SRC+=$(addprefix $(ROOTDIR)/module/sim/, $(SIM_SRC))
 APP_OBJ:=$(patsubst %.c, $(OBJ_DIR)/%.o, $(APP_SRC))
-SDK_OBJ:=$(builtin).o $(buildkey).o
+SDK_OBJ:=$(BUILTIN_OBJ) $(BUILDKEY_OBJ)
 OBJ_LIST+=$(APP_OBJ)
 OBJ_LIST+=$(SDK_OBJ)
 
@@ -30,8 +33,11 @@ $(OBJ_DIR)/%.o : %.c
 	mkdir -p $(dir $@)
 	$(CC) $(CFLAGS) -MMD -c $< -o $@
 
+# Counted by sim_stats.c and sim_energy.c
+SIM_WRAP+=ScheduleMessage GNSSFix Delay MicroSecondDelay BatteryGetVoltage
+
 $(PROGRAM_NAME) : $(OBJ_LIST) $(LIBS)
-	$(CC) $(OBJ_LIST) $(LDFLAGS) $(LIBS) $(LDFLAGS) -o $@
+	$(CC) $(OBJ_LIST) $(SIM_WRAP:%=-Wl,--wrap=%) $(LDFLAGS) $(LIBS) $(LDFLAGS) -o $@
 
 clean:
 	rm -f $(OBJ_LIST) $(PROGRAM_NAME)
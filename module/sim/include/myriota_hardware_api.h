@@ -14,6 +14,8 @@
 #ifndef MYRIOTA_HARDWARE_SIM_API_H
 #define MYRIOTA_HARDWARE_SIM_API_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <time.h>
 
 #ifdef __cplusplus
@@ -31,6 +33,36 @@ extern "C" {
 /// Next. A return value of 0 indicates no wakeup event.
 time_t ScheduleHook(time_t Next);
 
+/// Ends the simulation once the SIMDURATION environment variable's number of
+/// seconds have been simulated since STARTTIME. Does nothing when SIMDURATION
+/// isn't set. Applications implementing ScheduleHook should call it first.
+void SimDurationCheck(void);
+
+/// Delivers the events of the timeline file named by the SIMTIMELINE
+/// environment variable, or of SimTimelineDefault when it isn't set. Returns
+/// the same as ScheduleHook, which by default calls SimDurationCheck and then
+/// this. See module/sim/sim_timeline.c for the file format.
+time_t SimTimelineHook(time_t Next);
+
+/// Timeline used when SIMTIMELINE isn't set. Optionally defined by the
+/// application's simulation code.
+extern const char SimTimelineDefault[];
+
+/// Level of \p PinNum set by the timeline's gpio events, low until the first.
+int SimTimelineGPIO(uint8_t PinNum);
+
+/// Number of pulses added by the timeline's pulse events.
+uint64_t SimTimelinePulses(void);
+
+/// Reads up to \p Length bytes received by the timeline's leuart events.
+/// Returns the number of bytes read.
+int SimTimelineLeuartRead(uint8_t *Rx, size_t Length);
+
+/// Returns the next message received by the timeline's downlink events and
+/// its length in \p size, or NULL when there are none. Like ReceiveMessage
+/// the message is valid until the next call.
+uint8_t *SimTimelineDownlink(int *size);
+
 /// @}
 
 #ifdef __cplusplus
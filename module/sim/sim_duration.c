@@ -0,0 +1,42 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Ends the simulation after SIMDURATION simulated seconds from STARTTIME, so
+// examples can be run unattended for a fixed period.
+
+#include <stdlib.h>
+#include "myriota_user_api.h"
+
+void SimStatsWakeup(void);
+void SimEnergyWakeup(void);
+
+void SimDurationCheck(void) {
+  static time_t End = -1;
+
+  SimStatsWakeup();
+  SimEnergyWakeup();
+
+  if (End < 0) {
+    const char *Duration = getenv("SIMDURATION");
+    const char *Start = getenv("STARTTIME");
+    if (Duration == NULL)
+      End = 0;
+    else
+      End = (Start ? atol(Start) : TimeGet()) + atol(Duration);
+  }
+  if (End == 0 || TimeGet() < End) return;
+
+  printf("%ld Simulation ended\n", (long)TimeGet());
+  fflush(stdout);
+  exit(0);
+}
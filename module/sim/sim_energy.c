@@ -0,0 +1,199 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Energy model of the simulated module. The sleep current is drawn for the
+// whole simulated time and each activity adds its current for the time it
+// takes: job runs, Delay, GNSSFix, transmitting each scheduled message, the
+// daily receive windows and ADC or battery voltage samples. The application's
+// calls are redirected here, and to sim_stats.c, with the linker's --wrap
+// option.
+//
+// The currents and times are "<name> <value>" lines in the file named by
+// SIMENERGY, see Parameters for the names and defaults, which are only rough
+// figures to compare applications by. Set SIMENERGY to "default" to use the
+// defaults. The charge used is printed when the simulation exits and added to
+// the SIMSTATS file. Without SIMENERGY no charge is reported.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "myriota_user_api.h"
+
+void __real_Delay(uint32_t mSec);
+void __real_MicroSecondDelay(uint32_t uSec);
+int __real_BatteryGetVoltage(uint32_t *mV);
+
+typedef enum {
+  ENERGY_SLEEP,
+  ENERGY_AWAKE,
+  ENERGY_GNSS,
+  ENERGY_TX,
+  ENERGY_RX,
+  ENERGY_ADC,
+  ENERGY_ITEMS
+} EnergyItem;
+
+static const char *ItemNames[ENERGY_ITEMS] = {"sleep", "awake", "gnss",
+                                              "tx",    "rx",    "adc"};
+
+typedef enum {
+  SLEEP_UA,  // between jobs and in Sleep
+  AWAKE_MA,  // running a job or in Delay
+  JOB_MS,    // run time of each job
+  GNSS_MA,
+  GNSS_S,  // time of each GNSSFix
+  TX_MA,
+  TX_S,  // transmit time of each message, plus TX_S_PER_BYTE
+  TX_S_PER_BYTE,
+  RX_MA,
+  RX_S_PER_DAY,  // time listening to satellites each day
+  ADC_MA,
+  ADC_MS,  // time of each ADC or battery voltage sample
+  PARAMETERS
+} EnergyParameter;
+
+static struct {
+  const char *Name;
+  double Value;
+} Parameters[PARAMETERS] = {
+    [SLEEP_UA] = {"sleep_ua", 30},
+    [AWAKE_MA] = {"awake_ma", 5},
+    [JOB_MS] = {"job_ms", 10},
+    [GNSS_MA] = {"gnss_ma", 25},
+    [GNSS_S] = {"gnss_s", 30},
+    [TX_MA] = {"tx_ma", 400},
+    [TX_S] = {"tx_s", 2},
+    [TX_S_PER_BYTE] = {"tx_s_per_byte", 0.05},
+    [RX_MA] = {"rx_ma", 40},
+    [RX_S_PER_DAY] = {"rx_s_per_day", 600},
+    [ADC_MA] = {"adc_ma", 1},
+    [ADC_MS] = {"adc_ms", 1},
+};
+
+#define P(Name) (Parameters[Name].Value)
+
+static double Charge[ENERGY_ITEMS];  // mAs
+static time_t Start = -1;
+static bool Enabled;
+
+static void EnergyAdd(EnergyItem Item, double mA, double Seconds) {
+  Charge[Item] += mA * Seconds;
+}
+
+static void ParametersRead(const char *Name) {
+  char Line[128];
+  int LineNumber = 0;
+  FILE *f = fopen(Name, "r");
+
+  if (f == NULL) {
+    fprintf(stderr, "Failed to open SIMENERGY %s\n", Name);
+    exit(1);
+  }
+  while (fgets(Line, sizeof(Line), f)) {
+    char Key[32];
+    double Value;
+    int i;
+
+    LineNumber++;
+    if (sscanf(Line, " %31s", Key) != 1 || Key[0] == '#') continue;
+    for (i = 0; i < PARAMETERS; i++)
+      if (strcmp(Parameters[i].Name, Key) == 0) break;
+    if (i == PARAMETERS || sscanf(Line, " %*s %lf", &Value) != 1) {
+      fprintf(stderr, "%s:%d: invalid parameter %s\n", Name, LineNumber, Key);
+      exit(1);
+    }
+    Parameters[i].Value = Value;
+  }
+  fclose(f);
+}
+
+// Adds the charge which depends on the simulated time so far
+static void EnergyElapsed(double *Items) {
+  const double Seconds = Start < 0 ? 0 : TimeGet() - Start;
+
+  memcpy(Items, Charge, sizeof(Charge));
+  Items[ENERGY_SLEEP] += P(SLEEP_UA) / 1000 * Seconds;
+  Items[ENERGY_RX] += P(RX_MA) * P(RX_S_PER_DAY) * Seconds / 86400;
+}
+
+bool SimEnergyEnabled(void) { return Enabled; }
+
+double SimEnergyMah(void) {
+  double Items[ENERGY_ITEMS];
+  double Total = 0;
+
+  EnergyElapsed(Items);
+  for (int i = 0; i < ENERGY_ITEMS; i++) Total += Items[i];
+  return Total / 3600;
+}
+
+void SimEnergyWakeup(void) {
+  if (Start < 0) {
+    const char *StartTime = getenv("STARTTIME");
+    Start = StartTime ? atol(StartTime) : TimeGet();
+  }
+  EnergyAdd(ENERGY_AWAKE, P(AWAKE_MA), P(JOB_MS) / 1000);
+}
+
+void SimEnergyTransmit(size_t MessageSize) {
+  EnergyAdd(ENERGY_TX, P(TX_MA), P(TX_S) + P(TX_S_PER_BYTE) * MessageSize);
+}
+
+void SimEnergySample(void) {
+  EnergyAdd(ENERGY_ADC, P(ADC_MA), P(ADC_MS) / 1000);
+}
+
+void __wrap_Delay(uint32_t mSec) {
+  EnergyAdd(ENERGY_AWAKE, P(AWAKE_MA), mSec / 1e3);
+  __real_Delay(mSec);
+}
+
+void __wrap_MicroSecondDelay(uint32_t uSec) {
+  EnergyAdd(ENERGY_AWAKE, P(AWAKE_MA), uSec / 1e6);
+  __real_MicroSecondDelay(uSec);
+}
+
+// GNSSFix and ScheduleMessage are wrapped by sim_stats.c
+void SimEnergyGNSSFix(void) {
+  EnergyAdd(ENERGY_GNSS, P(GNSS_MA), P(GNSS_S));
+}
+
+int __wrap_BatteryGetVoltage(uint32_t *mV) {
+  SimEnergySample();
+  return __real_BatteryGetVoltage(mV);
+}
+
+static void EnergyReport(void) {
+  double Items[ENERGY_ITEMS];
+  const double Days = Start < 0 ? 0 : (TimeGet() - Start) / 86400.0;
+  const double Total = SimEnergyMah();
+
+  EnergyElapsed(Items);
+  printf("Energy over %.2f days: %.3f mAh", Days, Total);
+  if (Days > 0) printf(", %.3f mAh per day", Total / Days);
+  printf("\n");
+  for (int i = 0; i < ENERGY_ITEMS; i++) {
+    printf("  %-6s %10.3f mAh %5.1f%%\n", ItemNames[i], Items[i] / 3600,
+           Total > 0 ? 100 * Items[i] / 3600 / Total : 0);
+  }
+  fflush(stdout);
+}
+
+__attribute__((constructor)) static void EnergyInit(void) {
+  const char *Name = getenv("SIMENERGY");
+
+  if (Name == NULL) return;
+  if (strcmp(Name, "default") != 0) ParametersRead(Name);
+  Enabled = true;
+  atexit(EnergyReport);
+}
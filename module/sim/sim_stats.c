@@ -0,0 +1,94 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Per-device statistics for fleet simulations. The application's calls to
+// ScheduleMessage and GNSSFix are redirected here with the linker's --wrap
+// option. When SIMSTATS names a file the totals are written to it as JSON
+// when the simulation exits. SIMSEED seeds rand() so each simulated device
+// can behave differently but reproducibly.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include "myriota_user_api.h"
+
+int __real_ScheduleMessage(const uint8_t *Message, size_t MessageSize);
+int __real_GNSSFix(void);
+
+void SimEnergyTransmit(size_t MessageSize);
+void SimEnergyGNSSFix(void);
+bool SimEnergyEnabled(void);
+double SimEnergyMah(void);
+
+static struct {
+  unsigned messages;
+  unsigned message_bytes;
+  unsigned queue_overflows;
+  unsigned schedule_failures;
+  unsigned wakeups;
+  unsigned gnss_fixes;
+  unsigned gnss_failures;
+  time_t start;
+} Stats;
+
+int __wrap_ScheduleMessage(const uint8_t *Message, size_t MessageSize) {
+  // A full queue makes room by replacing a message already in it
+  if (MessageSlotsFree() == 0) Stats.queue_overflows++;
+  const int Result = __real_ScheduleMessage(Message, MessageSize);
+  if (Result < 0) {
+    Stats.schedule_failures++;
+  } else {
+    Stats.messages++;
+    Stats.message_bytes += MessageSize;
+    SimEnergyTransmit(MessageSize);
+  }
+  return Result;
+}
+
+int __wrap_GNSSFix(void) {
+  SimEnergyGNSSFix();
+  const int Result = __real_GNSSFix();
+  if (Result == 0)
+    Stats.gnss_fixes++;
+  else
+    Stats.gnss_failures++;
+  return Result;
+}
+
+void SimStatsWakeup(void) {
+  if (Stats.wakeups++ == 0) Stats.start = TimeGet();
+}
+
+static void StatsWrite(void) {
+  const char *Path = getenv("SIMSTATS");
+  FILE *f;
+
+  if (Path == NULL || (f = fopen(Path, "w")) == NULL) return;
+  fprintf(f,
+          "{\"start\": %ld, \"end\": %ld, \"messages\": %u, "
+          "\"message_bytes\": %u, \"queue_overflows\": %u, "
+          "\"schedule_failures\": %u, \"wakeups\": %u, \"gnss_fixes\": %u, "
+          "\"gnss_failures\": %u",
+          (long)Stats.start, (long)TimeGet(), Stats.messages,
+          Stats.message_bytes, Stats.queue_overflows, Stats.schedule_failures,
+          Stats.wakeups, Stats.gnss_fixes, Stats.gnss_failures);
+  // Only with the energy model, see sim_energy.c
+  if (SimEnergyEnabled()) fprintf(f, ", \"energy_mah\": %.3f", SimEnergyMah());
+  fprintf(f, "}\n");
+  fclose(f);
+}
+
+__attribute__((constructor)) static void StatsInit(void) {
+  const char *Seed = getenv("SIMSEED");
+  if (Seed) srand(atoi(Seed));
+  atexit(StatsWrite);
+}
@@ -0,0 +1,410 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Injects scripted events into the simulation. The timeline is read from the
+// file named by SIMTIMELINE, or from the application's SimTimelineDefault when
+// it isn't set, so scenarios can be changed without rebuilding. Each line is
+//
+//   <time> <event> [arguments]
+//
+// where time is an epoch time, "+" followed by seconds after STARTTIME, or
+// either of those followed by "/<period>" to repeat the event. "/<period>" on
+// its own repeats on whole periods since the epoch, e.g. "/1h" every hour.
+// Times take an s, m, h or d suffix. The events are
+//
+//   wake                     wakeup without changing any input
+//   gpio <pin> high|low|toggle
+//   pulse <count>            adds count pulses to the pulse counter
+//   leuart <text>            text is received, C escapes such as \r and \x41
+//                            are understood and it may be in double quotes
+//   downlink <hex>           a message is received
+//
+// Blank lines and lines starting with # are ignored. Events due at the same
+// time are delivered together with a single wakeup. The example's sim.c reads
+// the resulting input state through the SimTimeline functions.
+
+#include <ctype.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include "myriota_user_api.h"
+
+#define TIMELINE_PINS 64
+
+extern const char SimTimelineDefault[] __attribute__((weak));
+
+typedef enum {
+  TIMELINE_WAKE,
+  TIMELINE_GPIO,
+  TIMELINE_PULSE,
+  TIMELINE_LEUART,
+  TIMELINE_DOWNLINK
+} TimelineEventType;
+
+typedef struct {
+  time_t Time;
+  time_t Period;  // 0 for events which happen once
+  bool Done;
+  int Line;
+  TimelineEventType Type;
+  uint8_t Pin;
+  int Level;  // 0 low, 1 high or -1 to toggle
+  uint64_t Count;
+  uint8_t *Data;
+  size_t Size;
+} TimelineEvent;
+
+typedef struct Downlink {
+  struct Downlink *Next;
+  size_t Size;
+  uint8_t Data[];
+} Downlink;
+
+static struct {
+  bool Loaded;
+  const char *Name;
+  TimelineEvent *Events;
+  size_t Count;
+  size_t Capacity;
+  uint8_t Pins[TIMELINE_PINS];
+  uint64_t Pulses;
+  uint8_t *Leuart;
+  size_t LeuartSize;
+  Downlink *Downlinks;
+  Downlink *Received;  // last returned by SimTimelineDownlink
+} Timeline;
+
+static void TimelineError(int Line, const char *Message, const char *Text) {
+  fprintf(stderr, "%s:%d: %s \"%s\"\n", Timeline.Name, Line, Message, Text);
+  exit(1);
+}
+
+static const char *SkipSpace(const char *p) {
+  while (*p == ' ' || *p == '\t') p++;
+  return p;
+}
+
+// Parses a number of seconds with an optional unit suffix
+static const char *ParseSeconds(const char *p, time_t *Seconds) {
+  char *End;
+  long long Value = strtoll(p, &End, 10);
+
+  if (End == p) return NULL;
+  switch (*End) {
+    case 'd':
+      Value *= 24;
+      // fall through
+    case 'h':
+      Value *= 60;
+      // fall through
+    case 'm':
+      Value *= 60;
+      // fall through
+    case 's':
+      End++;
+  }
+  *Seconds = Value;
+  return End;
+}
+
+static const char *ParseTime(const char *p, time_t Start,
+                             TimelineEvent *Event) {
+  const char *Text = p;
+  const bool Aligned = *p == '/';
+  time_t Time = 0;
+
+  if (!Aligned) {
+    const bool Relative = *p == '+';
+    if (Relative) p++;
+    if ((p = ParseSeconds(p, &Time)) == NULL)
+      TimelineError(Event->Line, "invalid time", Text);
+    if (Relative) Time += Start;
+  }
+  Event->Time = Time;
+  Event->Period = 0;
+  if (*p == '/') {
+    p = ParseSeconds(p + 1, &Event->Period);
+    if (p == NULL || Event->Period <= 0)
+      TimelineError(Event->Line, "invalid period", Text);
+    if (Aligned) Event->Time = (Start / Event->Period + 1) * Event->Period;
+  }
+  if (*p != ' ' && *p != '\t') TimelineError(Event->Line, "invalid time", Text);
+  return SkipSpace(p);
+}
+
+static int HexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  c = tolower((unsigned char)c);
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+static void ParseText(const char *p, TimelineEvent *Event) {
+  const char *Text = p;
+  size_t Length = strlen(p);
+  uint8_t *Data = malloc(Length + 1);
+  size_t Size = 0;
+
+  if (Length >= 2 && p[0] == '"' && p[Length - 1] == '"') {
+    p++;
+    Length -= 2;
+  }
+  for (const char *End = p + Length; p < End; p++) {
+    if (*p != '\\' || p + 1 == End) {
+      Data[Size++] = *p;
+      continue;
+    }
+    switch (*++p) {
+      case 'n':
+        Data[Size++] = '\n';
+        break;
+      case 'r':
+        Data[Size++] = '\r';
+        break;
+      case 't':
+        Data[Size++] = '\t';
+        break;
+      case '0':
+        Data[Size++] = '\0';
+        break;
+      case 'x':
+        if (p + 2 >= End || HexDigit(p[1]) < 0 || HexDigit(p[2]) < 0)
+          TimelineError(Event->Line, "invalid escape in", Text);
+        Data[Size++] = HexDigit(p[1]) << 4 | HexDigit(p[2]);
+        p += 2;
+        break;
+      default:
+        Data[Size++] = *p;
+    }
+  }
+  Event->Data = Data;
+  Event->Size = Size;
+}
+
+static void ParseHex(const char *p, TimelineEvent *Event) {
+  const char *Text = p;
+  uint8_t *Data = malloc(strlen(p) / 2 + 1);
+  size_t Size = 0;
+
+  for (; *p; p += 2) {
+    if (HexDigit(p[0]) < 0 || HexDigit(p[1]) < 0)
+      TimelineError(Event->Line, "invalid hex", Text);
+    Data[Size++] = HexDigit(p[0]) << 4 | HexDigit(p[1]);
+  }
+  if (Size == 0) TimelineError(Event->Line, "empty downlink", Text);
+  Event->Data = Data;
+  Event->Size = Size;
+}
+
+static void ParseEvent(char *Line, time_t Start, TimelineEvent *Event) {
+  const char *p = ParseTime(SkipSpace(Line), Start, Event);
+  char Name[16] = {0};
+  int n = 0;
+
+  sscanf(p, "%15s%n", Name, &n);
+  p = SkipSpace(p + n);
+  if (strcmp(Name, "wake") == 0) {
+    Event->Type = TIMELINE_WAKE;
+  } else if (strcmp(Name, "gpio") == 0) {
+    unsigned Pin;
+    char Level[8] = {0};
+    Event->Type = TIMELINE_GPIO;
+    if (sscanf(p, "%u %7s", &Pin, Level) != 2 || Pin >= TIMELINE_PINS)
+      TimelineError(Event->Line, "invalid gpio event", p);
+    Event->Pin = Pin;
+    if (strcmp(Level, "high") == 0 || strcmp(Level, "1") == 0)
+      Event->Level = 1;
+    else if (strcmp(Level, "low") == 0 || strcmp(Level, "0") == 0)
+      Event->Level = 0;
+    else if (strcmp(Level, "toggle") == 0)
+      Event->Level = -1;
+    else
+      TimelineError(Event->Line, "invalid gpio level", Level);
+  } else if (strcmp(Name, "pulse") == 0) {
+    unsigned long long Count;
+    Event->Type = TIMELINE_PULSE;
+    if (sscanf(p, "%llu", &Count) != 1)
+      TimelineError(Event->Line, "invalid pulse count", p);
+    Event->Count = Count;
+  } else if (strcmp(Name, "leuart") == 0) {
+    Event->Type = TIMELINE_LEUART;
+    ParseText(p, Event);
+  } else if (strcmp(Name, "downlink") == 0) {
+    Event->Type = TIMELINE_DOWNLINK;
+    ParseHex(p, Event);
+  } else {
+    TimelineError(Event->Line, "unknown event", Name);
+  }
+}
+
+static void TimelineParse(char *Text, time_t Start) {
+  int LineNumber = 0;
+  char *Save;
+
+  for (char *Line = Text; Line != NULL; Line = Save) {
+    Save = strchr(Line, '\n');
+    if (Save) *Save++ = '\0';
+    LineNumber++;
+    // Trailing white space isn't part of leuart text unless quoted
+    for (size_t n = strlen(Line); n && isspace((unsigned char)Line[n - 1]);)
+      Line[--n] = '\0';
+    if (*SkipSpace(Line) == '\0' || *SkipSpace(Line) == '#') continue;
+
+    if (Timeline.Count == Timeline.Capacity) {
+      Timeline.Capacity = Timeline.Capacity ? 2 * Timeline.Capacity : 16;
+      Timeline.Events = realloc(Timeline.Events,
+                                Timeline.Capacity * sizeof(TimelineEvent));
+    }
+    TimelineEvent *Event = &Timeline.Events[Timeline.Count++];
+    memset(Event, 0, sizeof(*Event));
+    Event->Line = LineNumber;
+    ParseEvent(Line, Start, Event);
+  }
+}
+
+static char *ReadFile(const char *Name) {
+  FILE *f = fopen(Name, "r");
+  char *Text = NULL;
+  size_t Size = 0;
+
+  if (f == NULL) {
+    fprintf(stderr, "Failed to open SIMTIMELINE %s\n", Name);
+    exit(1);
+  }
+  while (!feof(f)) {
+    Text = realloc(Text, Size + 4096 + 1);
+    Size += fread(Text + Size, 1, 4096, f);
+    if (ferror(f)) {
+      fprintf(stderr, "Failed to read SIMTIMELINE %s\n", Name);
+      exit(1);
+    }
+  }
+  fclose(f);
+  Text[Size] = '\0';
+  return Text;
+}
+
+static void TimelineLoad(void) {
+  const char *Name = getenv("SIMTIMELINE");
+  const char *Start = getenv("STARTTIME");
+  char *Text;
+
+  Timeline.Loaded = true;
+  if (Name) {
+    Timeline.Name = Name;
+    Text = ReadFile(Name);
+  } else if (SimTimelineDefault) {
+    Timeline.Name = "SimTimelineDefault";
+    Text = strdup(SimTimelineDefault);
+  } else {
+    return;
+  }
+  TimelineParse(Text, Start ? atol(Start) : TimeGet());
+  free(Text);
+}
+
+static void TimelineDeliver(TimelineEvent *Event) {
+  switch (Event->Type) {
+    case TIMELINE_WAKE:
+      break;
+    case TIMELINE_GPIO:
+      if (Event->Level < 0)
+        Timeline.Pins[Event->Pin] = !Timeline.Pins[Event->Pin];
+      else
+        Timeline.Pins[Event->Pin] = Event->Level;
+      break;
+    case TIMELINE_PULSE:
+      Timeline.Pulses += Event->Count;
+      break;
+    case TIMELINE_LEUART:
+      Timeline.Leuart =
+          realloc(Timeline.Leuart, Timeline.LeuartSize + Event->Size);
+      memcpy(Timeline.Leuart + Timeline.LeuartSize, Event->Data, Event->Size);
+      Timeline.LeuartSize += Event->Size;
+      break;
+    case TIMELINE_DOWNLINK: {
+      Downlink *Message = malloc(sizeof(Downlink) + Event->Size);
+      Downlink **Tail = &Timeline.Downlinks;
+      Message->Next = NULL;
+      Message->Size = Event->Size;
+      memcpy(Message->Data, Event->Data, Event->Size);
+      while (*Tail) Tail = &(*Tail)->Next;
+      *Tail = Message;
+      break;
+    }
+  }
+}
+
+// Time of the earliest undelivered event, or -1 when there are none left
+static time_t TimelineNext(void) {
+  time_t Next = -1;
+  for (size_t i = 0; i < Timeline.Count; i++) {
+    const TimelineEvent *Event = &Timeline.Events[i];
+    if (!Event->Done && (Next < 0 || Event->Time < Next)) Next = Event->Time;
+  }
+  return Next;
+}
+
+time_t SimTimelineHook(time_t Next) {
+  if (!Timeline.Loaded) TimelineLoad();
+
+  const time_t When = TimelineNext();
+  if (When < 0 || When >= Next) return 0;
+
+  // Events at the same time are delivered in the order they were listed
+  for (size_t i = 0; i < Timeline.Count; i++) {
+    TimelineEvent *Event = &Timeline.Events[i];
+    if (Event->Done || Event->Time > When) continue;
+    TimelineDeliver(Event);
+    if (Event->Period)
+      Event->Time += Event->Period;
+    else
+      Event->Done = true;
+  }
+
+  raise(SIGUSR1);  // raise signal to indicate wakeup event
+  const time_t Now = TimeGet();
+  return When > Now ? When : Now;
+}
+
+int SimTimelineGPIO(uint8_t PinNum) {
+  return PinNum < TIMELINE_PINS ? Timeline.Pins[PinNum] : 0;
+}
+
+uint64_t SimTimelinePulses(void) { return Timeline.Pulses; }
+
+int SimTimelineLeuartRead(uint8_t *Rx, size_t Length) {
+  if (Length > Timeline.LeuartSize) Length = Timeline.LeuartSize;
+  memcpy(Rx, Timeline.Leuart, Length);
+  Timeline.LeuartSize -= Length;
+  memmove(Timeline.Leuart, Timeline.Leuart + Length, Timeline.LeuartSize);
+  return Length;
+}
+
+uint8_t *SimTimelineDownlink(int *size) {
+  free(Timeline.Received);
+  Timeline.Received = Timeline.Downlinks;
+  if (Timeline.Received == NULL) {
+    *size = 0;
+    return NULL;
+  }
+  Timeline.Downlinks = Timeline.Received->Next;
+  *size = Timeline.Received->Size;
+  return Timeline.Received->Data;
+}
+
+// Used when the application doesn't inject any events of its own
+__attribute__((weak)) time_t ScheduleHook(time_t Next) {
+  SimDurationCheck();
+  return SimTimelineHook(Next);
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Hierarchical timer wheel run from one scheduled job. Level 0 has a slot per
+// second and each level above covers TIMER_WHEEL_SLOTS slots of the one below,
+// so the default of 4 levels of 32 slots reaches 12 days ahead, and timers
+// further out wait in the last slot. Slots of higher levels are moved down as
+// the wheel reaches them. The job is scheduled for the earliest expiry.
+//
+// A timer expires at the latest time within its slack that is a multiple of
+// the largest power of two seconds which fits the slack. Timers with similar
+// slack so land on the same times and run in one wakeup.
+
+#include "myriota_timer_wheel.h"
+
+#ifndef TIMER_WHEEL_BITS
+#define TIMER_WHEEL_BITS 5
+#endif
+#ifndef TIMER_WHEEL_LEVELS
+#define TIMER_WHEEL_LEVELS 4
+#endif
+
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define SLOT_SHIFT(Level) ((Level) * TIMER_WHEEL_BITS)
+
+static Timer *Wheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+static time_t Clock;  // time the wheel has been advanced to
+static bool Running;  // in TimerJob, which reschedules itself on return
+
+static void ListAdd(Timer **List, Timer *t) {
+  t->Next = *List;
+  if (t->Next) t->Next->Link = &t->Next;
+  t->Link = List;
+  *List = t;
+}
+
+static void ListRemove(Timer *t) {
+  *t->Link = t->Next;
+  if (t->Next) t->Next->Link = t->Link;
+  t->Link = NULL;
+}
+
+static time_t ExpiryGet(time_t Deadline, uint32_t Slack) {
+  const time_t Latest = Deadline + Slack;
+  uint64_t Align = 1;
+
+  while (Align * 2 <= (uint64_t)Slack + 1) Align *= 2;
+  return Latest - Latest % Align;
+}
+
+static void WheelAdd(Timer *t) {
+  int Level = 0;
+
+  if (t->Expiry <= Clock) t->Expiry = Clock + 1;
+  while (Level < TIMER_WHEEL_LEVELS - 1 &&
+         (t->Expiry >> SLOT_SHIFT(Level)) - (Clock >> SLOT_SHIFT(Level)) >=
+             TIMER_WHEEL_SLOTS)
+    Level++;
+
+  const time_t Last = (Clock >> SLOT_SHIFT(Level)) + TIMER_WHEEL_SLOTS - 1;
+  time_t Slot = t->Expiry >> SLOT_SHIFT(Level);
+  if (Slot > Last) Slot = Last;
+  ListAdd(&Wheel[Level][Slot % TIMER_WHEEL_SLOTS], t);
+}
+
+// Earliest expiry, which is in the first used slot of one of the levels, or 0
+static time_t NextExpiry(void) {
+  time_t Next = 0;
+
+  for (int Level = 0; Level < TIMER_WHEEL_LEVELS; Level++) {
+    const time_t Base = Clock >> SLOT_SHIFT(Level);
+    Timer *t = NULL;
+    for (int i = 1; i < TIMER_WHEEL_SLOTS && t == NULL; i++)
+      t = Wheel[Level][(Base + i) % TIMER_WHEEL_SLOTS];
+    for (; t; t = t->Next)
+      if (Next == 0 || t->Expiry < Next) Next = t->Expiry;
+  }
+  return Next;
+}
+
+// Moves the timers of the slots passed on the way to Now to Expired or lower
+// levels
+static void WheelAdvance(time_t Now, Timer **Expired) {
+  Timer *Passed = NULL;
+
+  for (int Level = 0; Level < TIMER_WHEEL_LEVELS; Level++) {
+    const time_t From = Clock >> SLOT_SHIFT(Level);
+    const time_t To = Now >> SLOT_SHIFT(Level);
+    if (From == To) break;
+    for (time_t Slot = From + 1; Slot <= To && Slot <= From + TIMER_WHEEL_SLOTS;
+         Slot++) {
+      Timer **List = &Wheel[Level][Slot % TIMER_WHEEL_SLOTS];
+      while (*List) {
+        Timer *t = *List;
+        ListRemove(t);
+        ListAdd(&Passed, t);
+      }
+    }
+  }
+  Clock = Now;
+  while (Passed) {
+    Timer *t = Passed;
+    ListRemove(t);
+    if (t->Expiry <= Now)
+      ListAdd(Expired, t);
+    else
+      WheelAdd(t);
+  }
+}
+
+static time_t TimerJob(void) {
+  const time_t Now = TimeGet();
+  Timer *Expired = NULL;
+
+  Running = true;
+  if (Now > Clock) WheelAdvance(Now, &Expired);
+  while (Expired) {
+    Timer *t = Expired;
+    ListRemove(t);
+    if (t->Period) {
+      // Skip any runs missed, keeping to the period of the first deadline
+      t->Deadline += ((Now - t->Deadline) / t->Period + 1) * t->Period;
+      t->Expiry = ExpiryGet(t->Deadline, t->Slack);
+      WheelAdd(t);
+    }
+    t->Callback(t);
+  }
+  Running = false;
+
+  const time_t Next = NextExpiry();
+  return Next ? Next : Never();
+}
+
+static int TimerSchedule(void) {
+  if (Running) return 0;
+  const time_t Next = NextExpiry();
+  return ScheduleJob(TimerJob, Next ? Next : Never());
+}
+
+int TimerStart(Timer *t, uint32_t Seconds) {
+  const time_t Now = TimeGet();
+
+  if (t->Link) ListRemove(t);
+  if (Clock == 0) Clock = Now;
+  t->Deadline = Now + Seconds;
+  t->Expiry = ExpiryGet(t->Deadline, t->Slack);
+  WheelAdd(t);
+  return TimerSchedule();
+}
+
+void TimerStop(Timer *t) {
+  if (t->Link == NULL) return;
+  ListRemove(t);
+  TimerSchedule();
+}
+
+bool TimerActive(const Timer *t) { return t->Link != NULL; }
@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import argparse
+import concurrent.futures
+import csv
+import json
+import os
+import random
+import subprocess
+import sys
+import tempfile
+import time
+
+STATS = [
+    "messages",
+    "message_bytes",
+    "queue_overflows",
+    "schedule_failures",
+    "wakeups",
+    "gnss_fixes",
+    "gnss_failures",
+]
+
+STARTTIME = 1672531200
+DURATION = 7 * 24 * 3600
+
+
+def read_locations(filename):
+    """Reads "latitude,longitude" lines, skipping a header if there is one"""
+    locations = []
+    with open(filename, "r") as f:
+        for row in csv.reader(f):
+            try:
+                locations.append((float(row[0]), float(row[1])))
+            except (ValueError, IndexError):
+                continue
+    return locations
+
+
+def device_config(index, args, locations):
+    """Returns the environment of simulated device index"""
+    rng = random.Random(args.seed * 1000003 + index)
+    if locations:
+        latitude, longitude = locations[index % len(locations)]
+    else:
+        latitude = rng.uniform(args.area[0], args.area[2])
+        longitude = rng.uniform(args.area[1], args.area[3])
+    return {
+        "STARTTIME": str(args.start + rng.randint(0, args.start_spread)),
+        "LATITUDE": "%.7f" % latitude,
+        "LONGITUDE": "%.7f" % longitude,
+        "SIMDURATION": str(args.duration),
+        "SIMSEED": str(rng.randint(0, 2**31 - 1)),
+    }
+
+
+def run_device(index, program, config, args, stats_dir):
+    """Runs one simulated device. Returns its config merged with its stats."""
+    env = dict(os.environ)
+    env.update(config)
+    env["SIMSTATS"] = os.path.join(stats_dir, "%d.json" % index)
+    if args.energy:
+        env["SIMENERGY"] = args.energy
+    result = {"device": index}
+    result.update(config)
+    if args.log_dir:
+        output = open(os.path.join(args.log_dir, "%d.log" % index), "w")
+    else:
+        output = subprocess.DEVNULL
+    start = time.time()
+    try:
+        process = subprocess.run(
+            [program],
+            cwd=os.path.dirname(program),
+            env=env,
+            stdin=subprocess.DEVNULL,
+            stdout=output,
+            stderr=subprocess.STDOUT,
+            timeout=args.timeout,
+        )
+        result["exit"] = process.returncode
+    except subprocess.TimeoutExpired:
+        result["exit"] = "timeout"
+    finally:
+        if output is not subprocess.DEVNULL:
+            output.close()
+    result["elapsed"] = round(time.time() - start, 3)
+    try:
+        with open(env["SIMSTATS"], "r") as f:
+            result.update(json.load(f))
+        os.remove(env["SIMSTATS"])
+    except (IOError, ValueError):
+        result["exit"] = result["exit"] or "no stats"
+    return result
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(fraction * len(values)))]
+
+
+def print_report(results, args, elapsed, out=sys.stdout):
+    ok = [r for r in results if r["exit"] == 0 and "messages" in r]
+    failed = [r for r in results if r not in ok]
+    days = args.duration / 86400.0
+    out.write(
+        "%d devices, %.1f simulated days each, %.1fs wall clock, %d failed\n\n"
+        % (len(results), days, elapsed, len(failed))
+    )
+    out.write(
+        "%-18s %12s %10s %8s %8s %8s %8s\n"
+        % ("Per device", "Total", "Mean", "Min", "p50", "p95", "Max")
+    )
+    for stat in STATS:
+        values = [r[stat] for r in ok]
+        total = sum(values)
+        out.write(
+            "%-18s %12d %10.1f %8d %8d %8d %8d\n"
+            % (
+                stat,
+                total,
+                total / len(values) if values else 0,
+                min(values) if values else 0,
+                percentile(values, 0.5),
+                percentile(values, 0.95),
+                max(values) if values else 0,
+            )
+        )
+    energy = [r["energy_mah"] / days for r in ok if "energy_mah" in r and days]
+    if energy:
+        out.write(
+            "%-18s %12.2f %10.3f %8.3f %8.3f %8.3f %8.3f\n"
+            % (
+                "mAh per day",
+                sum(energy),
+                sum(energy) / len(energy),
+                min(energy),
+                percentile(energy, 0.5),
+                percentile(energy, 0.95),
+                max(energy),
+            )
+        )
+    if ok and days:
+        messages = sum(r["messages"] for r in ok)
+        overflowing = sum(1 for r in ok if r["queue_overflows"])
+        out.write(
+            "\nMessages per device per day: %.2f\n" % (messages / len(ok) / days)
+        )
+        out.write(
+            "Devices with queue overflows: %d (%.1f%%)\n"
+            % (overflowing, 100.0 * overflowing / len(ok))
+        )
+        if args.fleet_size:
+            out.write(
+                "Fleet of %d: %.0f messages per day\n"
+                % (args.fleet_size, messages / len(ok) / days * args.fleet_size)
+            )
+    for r in failed[:10]:
+        out.write("Device %d failed: %s\n" % (r["device"], r["exit"]))
+
+
+def main():
+    """Implements main CLI entrypoint"""
+    parser = argparse.ArgumentParser(
+        description="Run a fleet of simulated modules, each with its own location, "
+        "start time and seed, and report per-device statistics. The program must "
+        "be built with MODULE=sim or MODULE=g2/sim",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    parser.add_argument("program", help="Simulator build of the application")
+    parser.add_argument("-n", "--devices", type=int, default=100)
+    parser.add_argument(
+        "-j", "--jobs", type=int, default=os.cpu_count() or 1, help="Parallel devices"
+    )
+    parser.add_argument(
+        "-d", "--duration", type=int, default=DURATION, help="Simulated seconds"
+    )
+    parser.add_argument("--start", type=int, default=STARTTIME, help="Epoch start")
+    parser.add_argument(
+        "--start-spread",
+        type=int,
+        default=24 * 3600,
+        help="Devices start at a random time up to this many seconds after --start",
+    )
+    parser.add_argument(
+        "--area",
+        type=float,
+        nargs=4,
+        default=[-43.0, 113.0, -11.0, 153.0],
+        metavar=("LAT_MIN", "LON_MIN", "LAT_MAX", "LON_MAX"),
+        help="Devices are placed uniformly in this area",
+    )
+    parser.add_argument(
+        "-l", "--locations", help="CSV of latitude,longitude to place devices at"
+    )
+    parser.add_argument("-s", "--seed", type=int, default=0, help="Fleet seed")
+    parser.add_argument(
+        "-t", "--timeout", type=int, default=600, help="Wall clock limit per device"
+    )
+    parser.add_argument(
+        "-f", "--fleet-size", type=int, help="Scale the message totals to this fleet"
+    )
+    parser.add_argument(
+        "-e", "--energy", help="Energy model parameters, passed on as SIMENERGY"
+    )
+    parser.add_argument("-o", "--output", help="Write per-device results as CSV")
+    parser.add_argument("--log-dir", help="Keep the output of each device here")
+    args = parser.parse_args()
+
+    program = os.path.abspath(args.program)
+    if not os.access(program, os.X_OK):
+        sys.exit("%s is not an executable" % args.program)
+    locations = read_locations(args.locations) if args.locations else None
+    if args.log_dir:
+        os.makedirs(args.log_dir, exist_ok=True)
+
+    results = []
+    start = time.time()
+    with tempfile.TemporaryDirectory() as stats_dir:
+        with concurrent.futures.ThreadPoolExecutor(args.jobs) as pool:
+            futures = [
+                pool.submit(
+                    run_device,
+                    i,
+                    program,
+                    device_config(i, args, locations),
+                    args,
+                    stats_dir,
+                )
+                for i in range(args.devices)
+            ]
+            for i, future in enumerate(concurrent.futures.as_completed(futures)):
+                results.append(future.result())
+                if sys.stderr.isatty():
+                    sys.stderr.write("\r%d/%d devices" % (i + 1, args.devices))
+    if sys.stderr.isatty():
+        sys.stderr.write("\n")
+    results.sort(key=lambda r: r["device"])
+
+    if args.output:
+        columns = ["device", "STARTTIME", "LATITUDE", "LONGITUDE", "SIMSEED"]
+        columns += ["exit", "elapsed"] + STATS
+        if args.energy:
+            columns.append("energy_mah")
+        with open(args.output, "w", newline="") as f:
+            writer = csv.DictWriter(f, columns, extrasaction="ignore")
+            writer.writeheader()
+            writer.writerows(results)
+    print_report(results, args, time.time() - start)
+
+
+if __name__ == "__main__":
+    main()
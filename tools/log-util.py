@@ -23,6 +23,15 @@ import argparse
 import binascii
 import signal
 import io
+import csv
+import json
+import calendar
+import concurrent.futures
+import fnmatch
+import itertools
+import os
+import re
+import sqlite3
 
 errors = {
     0: "Internal test",
@@ -59,6 +68,11 @@ unpack_strings = {
     "Satellite communication stats": "<IHHHH",
 }
 
+# Codes whose payload is a sequence of records of the same layout
+repeated_unpack_strings = {
+    "Job profile": "<IIIHH",
+}
+
 contents = {
     "Internal test": ["Test1", "Test2"],
     "Watchdog reset": ["Job ID", "PC", "LR"],
@@ -103,6 +117,13 @@ contents = {
         "RX unverified",
         "TX attempt",
     ],
+    "Job profile": [
+        "Job",
+        "Runs",
+        "Total run ticks",
+        "Max run ticks",
+        "Wakeups",
+    ],
 }
 
 reset_reasons = {
@@ -174,117 +195,517 @@ def append_newline(a, b):
     return join_optional([a, b], separator="\n")
 
 
-def decode_log(logdata: bytearray):
+header_struct = struct.Struct("<IHH")
+
+# Precompiled payload decoders for the standard codes
+record_structs = {key: struct.Struct(fmt) for key, fmt in unpack_strings.items()}
+repeated_structs = {
+    key: struct.Struct(fmt) for key, fmt in repeated_unpack_strings.items()
+}
+
+# User error code of job profiles, JOB_PROFILE_LOG_CODE in job_profile.mk
+JOB_PROFILE_LOG_CODE = 126
+job_profile_code = JOB_PROFILE_LOG_CODE
+
+# Function names by address, from a linker map, to name jobs by
+job_names = {}
+
+
+def set_decode_options(code=JOB_PROFILE_LOG_CODE, names=None):
+    """
+    Set the user error code decoded as job profiles and the function names
+    jobs are named by. Decoder processes are set up with the same options.
+    """
+    global job_profile_code
+    errors.pop(0x80 + job_profile_code, None)
+    job_profile_code = code
+    errors[0x80 + job_profile_code] = "Job profile"
+    if names is not None:
+        job_names.clear()
+        job_names.update(names)
+
+
+set_decode_options()
+
+
+def load_map(filename):
+    """
+    Read the function addresses of a linker map, e.g. obj/map.out. Functions
+    are in sections of their own, .text.NAME, as built with
+    -ffunction-sections. The address of a section may be on the next line.
+    """
+    names = {}
+    name = None
+    with open(filename, "r") as f:
+        for line in f:
+            match = re.match(r"^ \.text\.(\S+)(\s+0x([0-9a-f]+))?", line)
+            if match:
+                name = match.group(1)
+                if match.group(3) is None:
+                    continue
+                address = match.group(3)
+            else:
+                match = re.match(r"^\s+0x([0-9a-f]+)\s+0x", line)
+                if name is None or match is None:
+                    name = None
+                    continue
+                address = match.group(1)
+            names[int(address, 16)] = name
+            name = None
+    return names
+
+
+def job_name(address):
+    # Thumb function addresses have the lowest bit set
+    name = job_names.get(address & ~1)
+    return "0x%08x" % address if name is None else "%s (0x%08x)" % (name, address)
+
+
+def decode_repeated(key, payload):
     """
-    Convert a binary log file into a list of:
+    Decode a payload of records of the same layout into a list of fields and
+    the detail text.
+    """
+    record = repeated_structs[key]
+    fields = []
+    detail = None
+    end = len(payload) - len(payload) % record.size
+    for values in record.iter_unpack(bytes(payload[:end])):
+        fields.append(dict(zip(contents[key], values)))
+        if key == "Job profile":
+            job, runs, total, maximum, wakeups = values
+            detail_str = "%s : runs %d, total %d ms, max %d ms, wakeups %d" % (
+                job_name(job),
+                runs,
+                total,
+                maximum,
+                wakeups,
+            )
+            detail = append_newline(detail, detail_str)
+    return fields, detail
+
+
+def iter_log(stream):
+    """
+    Decode log entries from a binary stream one at a time. stream only
+    needs a read() method, so it can be a file or a live serial dump. Yields:
     {
         "timestamp": ...
+        "time": ...
+        "code": ...
         "key": ...
         "detail": ...
+        "fields": ...
     }
+    fields is a list with one dict per record for codes with repeated
+    records, e.g. "Job profile".
     """
-    records = []
-    binary_file = io.BytesIO(logdata)
-
     # Entry format, in little endian
-    # |0-1|2-3|4-?|
-    # |Length|Code|Payload|
+    # |0-3|4-5|6-7|8-?|
+    # |Timestamp|Length|Code|Payload|
     while True:
         entry = {
             "timestamp": None,
+            "time": None,
+            "code": None,
             "key": None,
             "detail": None,
+            "fields": None,
         }
 
-        bytes = binary_file.read(8)
-        if len(bytes) == 0:
-            return records
-
-        if len(bytes) < 8:
-            if len(bytes) > 0:
-                entry["detail"] = "Incomplete log entry"
-            return records
-        timestamp = struct.unpack("<IHH", bytes)
-        timestamp, length, code = struct.unpack("<IHH", bytes)
+        bytes = stream.read(header_struct.size)
+        if len(bytes) < header_struct.size:
+            return
+        timestamp, length, code = header_struct.unpack(bytes)
         # End of the log
         if timestamp == 0xFFFFFFFF:
-            return records
+            return
         # UTC time
-        time_string = time.strftime(
+        entry["timestamp"] = time.strftime(
             "%Y-%m-%d %H:%M:%S UTC", time.gmtime(float(timestamp))
         )
-        entry["timestamp"] = time_string
-        records.append(entry)
-        # try standard user codes:
-        try:
-            key = errors[code]
+        entry["time"] = timestamp
+        entry["code"] = code
+
+        payload = None
+        if length != 0:
+            try:
+                payload = read_and_check_completion(stream, length)
+            except ValueError as e:
+                entry["key"] = errors.get(code, "Error code %d" % code)
+                entry["detail"] = append_newline(entry["detail"], e)
+                yield entry
+                return
+
+        # try standard codes:
+        key = errors.get(code)
+        if key is not None:
             entry["key"] = key
-            if length == 0:
+            if payload is None:
+                yield entry
                 continue
-            else:
+            if key in repeated_structs:
+                entry["fields"], entry["detail"] = decode_repeated(key, payload)
+                yield entry
+                continue
+            if key in record_structs:
                 try:
-                    bytes = read_and_check_completion(binary_file, length)
-                    values = struct.unpack(unpack_strings[key], bytes)
+                    values = record_structs[key].unpack(payload)
+                    entry["fields"] = dict(zip(contents[key], values))
                     for k, v in zip(contents[key], values):
                         detail_str = "%s : 0x%08x(%d)" % (k, v, v)
                         entry["detail"] = append_newline(entry["detail"], detail_str)
                     if key == "Reset reason":
                         detail_str = reset_reasons[values[0]]
                         entry["detail"] = append_newline(entry["detail"], detail_str)
+                    yield entry
                     continue
-                except ValueError as e:
-                    entry["detail"] = append_newline(entry["detail"], e)
-                    return records
-        except struct.error:
-            if code < 0x80:
-                error_str = "Unable to decode\n%s" % bytes_to_str(bytes)
-                entry["detail"] = append_newline(entry["detail"], error_str)
-                continue
-            else:
-                binary_file.seek(-len(bytes), 1)
-        except KeyError:
-            pass
+                except struct.error:
+                    if code < 0x80:
+                        error_str = "Unable to decode\n%s" % bytes_to_str(payload)
+                        entry["detail"] = append_newline(entry["detail"], error_str)
+                        yield entry
+                        continue
         # try user code:
         if code >= 0x80 and code <= 0x80 + 0xFF:
             entry["key"] = "User error code %d" % (code - 0x80)
-            if length != 0:
-                try:
-                    bytes = read_and_check_completion(binary_file, length)
-                    entry["detail"] = append_newline(
-                        entry["detail"], bytes_to_str(bytes)
-                    )
-                    continue
-                except ValueError as e:
-                    entry["detail"] = append_newline(entry["detail"], e)
-                    return records
-        # unknown log code:
-        if length != 0:
+        elif payload is not None:
             entry["key"] = "Unknown error code %d" % code
-            try:
-                bytes = read_and_check_completion(binary_file, length)
-                entry["detail"] = append_newline(entry["detail"], bytes_to_str(bytes))
-                continue
-            except ValueError as e:
-                entry["detail"] = append_newline(entry["detail"], e)
-                return records
+        if payload is not None:
+            entry["detail"] = append_newline(entry["detail"], bytes_to_str(payload))
+        yield entry
+
+
+def decode_log(logdata: bytearray):
+    """
+    Convert a binary log file into a list of entries, see iter_log.
+    """
+    return list(iter_log(io.BytesIO(logdata)))
+
+
+def entry_to_string(entry):
+    timestamp = entry["timestamp"] if entry["timestamp"] else ""
+    key = entry["key"] if entry["key"] else ""
+    title = " ".join([timestamp, key]).strip()
+    return append_newline("====%s====" % title, entry["detail"])
 
 
 def log_to_string(log_detail):
     string_lines = []
     if log_detail:
         for entry in log_detail:
-            timestamp = entry["timestamp"] if entry["timestamp"] else ""
-            key = entry["key"] if entry["key"] else ""
-            title = " ".join([timestamp, key]).strip()
-            string_lines.append("====%s====" % title)
-            if entry["detail"]:
-                string_lines.append(entry["detail"])
+            string_lines.append(entry_to_string(entry))
     else:
         string_lines.append("No log found")
 
     return "\n".join(string_lines)
 
 
+CSV_COLUMNS = ["timestamp", "code", "key", "detail"]
+
+
+def write_log(entries, output_format="text", out=sys.stdout):
+    """
+    Write entries to out as they are decoded, in text, JSON Lines or CSV
+    format. Returns the number of entries written.
+    """
+    count = 0
+    if output_format == "csv":
+        writer = csv.DictWriter(out, CSV_COLUMNS, extrasaction="ignore")
+        writer.writeheader()
+    for entry in entries:
+        if output_format == "jsonl":
+            out.write(json.dumps(entry) + "\n")
+        elif output_format == "csv":
+            writer.writerow(entry)
+        else:
+            out.write(entry_to_string(entry) + "\n")
+        out.flush()
+        count += 1
+    if count == 0 and output_format == "text":
+        out.write("No log found\n")
+    return count
+
+
+class HexLogReader:
+    """
+    Binary stream over the hexadecimal lines of a log dump from the
+    bootloader. Decoded bytes are optionally copied to tee.
+    """
+
+    def __init__(self, ser, tee=None):
+        self.ser = ser
+        self.tee = tee
+        self.hex = b""
+        self.buffer = bytearray()
+        self.done = False
+
+    def _fill(self):
+        out = self.ser.readline()
+        if len(out) > 16:
+            self.hex += out.strip()
+            even = len(self.hex) & ~1
+            data = binascii.unhexlify(self.hex[:even])
+            self.hex = self.hex[even:]
+            if self.tee is not None:
+                self.tee.write(data)
+            self.buffer += data
+        elif len(out) == 0:
+            self.done = True
+
+    def read(self, size):
+        while len(self.buffer) < size and not self.done:
+            self._fill()
+        data = bytes(self.buffer[:size])
+        del self.buffer[:size]
+        return data
+
+    def drain(self):
+        # Consume the rest of the dump so that the saved log is complete
+        while not self.done:
+            self._fill()
+        self.buffer = bytearray()
+
+
+# Number of entries covered by each block of the sparse log index
+INDEX_BLOCK_ENTRIES = 256
+
+
+def build_index(binary_file, block_entries=INDEX_BLOCK_ENTRIES):
+    """
+    Build a sparse index of a log file by walking the entry headers only.
+    Returns a list of [offset, minimum time, maximum time, codes] per block
+    of block_entries entries.
+    """
+    blocks = []
+    offset = count = 0
+    binary_file.seek(0)
+    while True:
+        bytes = binary_file.read(header_struct.size)
+        if len(bytes) < header_struct.size:
+            break
+        timestamp, length, code = header_struct.unpack(bytes)
+        if timestamp == 0xFFFFFFFF:
+            break
+        if count % block_entries == 0:
+            block = [offset, timestamp, timestamp, []]
+            blocks.append(block)
+        block[1] = min(block[1], timestamp)
+        block[2] = max(block[2], timestamp)
+        if code not in block[3]:
+            block[3].append(code)
+        count += 1
+        # Payloads are 4 bytes aligned
+        offset += header_struct.size + (length + 3) // 4 * 4
+        binary_file.seek(offset)
+    return blocks
+
+
+def load_index(filename, binary_file):
+    """
+    Returns the sparse index of a log file, from the cached FILE.idx if it
+    is still valid or freshly built and cached otherwise.
+    """
+    st = os.stat(filename)
+    index_filename = filename + ".idx"
+    try:
+        with open(index_filename, "r") as f:
+            index = json.load(f)
+        if (
+            index["size"] == st.st_size
+            and index["mtime"] == st.st_mtime
+            and index["block"] == INDEX_BLOCK_ENTRIES
+        ):
+            return index["blocks"]
+    except (IOError, ValueError, KeyError):
+        pass
+
+    blocks = build_index(binary_file)
+    index = {
+        "size": st.st_size,
+        "mtime": st.st_mtime,
+        "block": INDEX_BLOCK_ENTRIES,
+        "blocks": blocks,
+    }
+    try:
+        with open(index_filename, "w") as f:
+            json.dump(index, f)
+    except IOError:
+        pass
+    return blocks
+
+
+def filter_log(entries, time_from=None, time_to=None, codes=None):
+    for entry in entries:
+        if time_from is not None and entry["time"] < time_from:
+            continue
+        if time_to is not None and entry["time"] > time_to:
+            continue
+        if codes and entry["code"] not in codes:
+            continue
+        yield entry
+
+
+def iter_log_indexed(binary_file, blocks, time_from=None, time_to=None, codes=None):
+    """
+    Decode only the blocks of the index that can hold entries within the
+    time range and with one of the codes.
+    """
+    for offset, tmin, tmax, block_codes in blocks:
+        if time_from is not None and tmax < time_from:
+            continue
+        if time_to is not None and tmin > time_to:
+            continue
+        if codes and not set(codes).intersection(block_codes):
+            continue
+        binary_file.seek(offset)
+        block = itertools.islice(iter_log(binary_file), INDEX_BLOCK_ENTRIES)
+        for entry in filter_log(block, time_from, time_to, codes):
+            yield entry
+
+
+def parse_time(value):
+    """Epoch seconds or a UTC date and time, e.g. '2025-01-31 13:00:00'"""
+    try:
+        return int(value)
+    except ValueError:
+        pass
+    for fmt in ("%Y-%m-%d %H:%M:%S", "%Y-%m-%dT%H:%M:%S", "%Y-%m-%d %H:%M", "%Y-%m-%d"):
+        try:
+            return calendar.timegm(time.strptime(value, fmt))
+        except ValueError:
+            continue
+    raise argparse.ArgumentTypeError("invalid time '%s'" % value)
+
+
+def parse_user_code(value):
+    """User error code, 0 - 127"""
+    try:
+        code = int(value, 0)
+    except ValueError:
+        code = -1
+    if not 0 <= code <= 127:
+        raise argparse.ArgumentTypeError("invalid user error code '%s'" % value)
+    return code
+
+
+def sql_name(name):
+    return re.sub(r"[^0-9a-z]+", "_", name.lower()).strip("_")
+
+
+def decode_file(path):
+    """
+    Decode one log file for the batch mode. Returns the module ID if logged,
+    all entries as (time, code, key, detail) rows, and the decoded fields of
+    the standard codes as rows grouped by key.
+    """
+    module_id = None
+    entries = []
+    records = {}
+    with open(path, "rb") as binary_file:
+        for entry in iter_log(binary_file):
+            t = entry["time"]
+            entries.append((t, entry["code"], entry["key"], entry["detail"]))
+            if isinstance(entry["fields"], list):
+                for fields in entry["fields"]:
+                    row = (t,) + tuple(fields.values())
+                    records.setdefault(entry["key"], []).append(row)
+            elif entry["fields"]:
+                row = (t,) + tuple(entry["fields"].values())
+                records.setdefault(entry["key"], []).append(row)
+                if entry["key"] == "Module ID":
+                    module_id = "%010x" % entry["fields"]["Module ID"]
+    return path, module_id, entries, records
+
+
+def create_tables(db):
+    db.execute(
+        "CREATE TABLE IF NOT EXISTS logs (id INTEGER PRIMARY KEY, "
+        "path TEXT UNIQUE, size INTEGER, mtime REAL, module_id TEXT)"
+    )
+    db.execute(
+        "CREATE TABLE IF NOT EXISTS entries "
+        "(log_id INTEGER, time INTEGER, code INTEGER, key TEXT, detail TEXT)"
+    )
+    db.execute("CREATE INDEX IF NOT EXISTS entries_code ON entries (code, time)")
+    # One table per standard code with decoded fields, e.g. watchdog_reset
+    for key, fields in contents.items():
+        columns = ", ".join("%s INTEGER" % sql_name(f) for f in fields)
+        db.execute(
+            "CREATE TABLE IF NOT EXISTS %s (log_id INTEGER, time INTEGER, %s)"
+            % (sql_name(key), columns)
+        )
+
+
+def batch_decode(directory, database, pattern="*.bin", jobs=None, status=sys.stdout):
+    """
+    Decode all log files under directory in parallel into an SQLite
+    database. Files already decoded and unchanged since are skipped.
+    """
+    db = sqlite3.connect(database)
+    create_tables(db)
+
+    paths = {}
+    for root, _, files in os.walk(directory):
+        for name in fnmatch.filter(files, pattern):
+            path = os.path.abspath(os.path.join(root, name))
+            st = os.stat(path)
+            paths[path] = (st.st_size, st.st_mtime)
+
+    todo = []
+    for path, (size, mtime) in sorted(paths.items()):
+        row = db.execute(
+            "SELECT id, size, mtime FROM logs WHERE path = ?", (path,)
+        ).fetchone()
+        if row is not None:
+            if (row[1], row[2]) == (size, mtime):
+                continue
+            db.execute("DELETE FROM entries WHERE log_id = ?", (row[0],))
+            for key in contents:
+                db.execute("DELETE FROM %s WHERE log_id = ?" % sql_name(key), (row[0],))
+            db.execute("DELETE FROM logs WHERE id = ?", (row[0],))
+        todo.append(path)
+
+    print(
+        "Decoding %d of %d log files into %s" % (len(todo), len(paths), database),
+        file=status,
+    )
+    with concurrent.futures.ProcessPoolExecutor(
+        jobs, initializer=set_decode_options, initargs=(job_profile_code, job_names)
+    ) as pool:
+        for path, module_id, entries, records in pool.map(
+            decode_file, todo, chunksize=4
+        ):
+            size, mtime = paths[path]
+            log_id = db.execute(
+                "INSERT INTO logs (path, size, mtime, module_id) VALUES (?, ?, ?, ?)",
+                (path, size, mtime, module_id),
+            ).lastrowid
+            db.executemany(
+                "INSERT INTO entries VALUES (?, ?, ?, ?, ?)",
+                [(log_id,) + e for e in entries],
+            )
+            for key, rows in records.items():
+                db.executemany(
+                    "INSERT INTO %s VALUES (%s)"
+                    % (sql_name(key), ", ".join(["?"] * (len(rows[0]) + 1))),
+                    [(log_id,) + r for r in rows],
+                )
+    db.commit()
+    db.close()
+
+
+def query_database(database, query, out=sys.stdout):
+    db = sqlite3.connect(database)
+    cursor = db.execute(query)
+    writer = csv.writer(out)
+    if cursor.description:
+        writer.writerow([d[0] for d in cursor.description])
+        for row in cursor:
+            writer.writerow(row)
+    db.close()
+
+
 def capture_bootloader(portname, baudrate, wait_flag):
     if wait_flag:
         print("Waiting for serial port", portname)
@@ -349,18 +770,11 @@ def capture_bootloader(portname, baudrate, wait_flag):
     return ser
 
 
-def read_log(ser):
-    print("Start reading the log")
+def read_log(ser, tee=None, status=sys.stdout):
+    print("Start reading the log", file=status)
     # Start dumping
     ser.write(b"x")
-    dump = b""
-    while True:
-        out = ser.readline()
-        if len(out) > 16:
-            dump += out.strip()
-        elif len(out) == 0:
-            break
-    return dump
+    return HexLogReader(ser, tee)
 
 
 def purge_log(ser):
@@ -447,6 +861,94 @@ def main():
         help="set the serial port BAUDRATE",
     )
 
+    parser.add_argument(
+        "-f",
+        "--format",
+        dest="output_format",
+        choices=["text", "jsonl", "csv"],
+        default="text",
+        help="output format of the decoded log",
+    )
+
+    parser.add_argument(
+        "--from",
+        dest="time_from",
+        metavar="TIME",
+        type=parse_time,
+        help="only show entries logged at or after TIME (epoch or UTC date)",
+    )
+    parser.add_argument(
+        "--to",
+        dest="time_to",
+        metavar="TIME",
+        type=parse_time,
+        help="only show entries logged at or before TIME (epoch or UTC date)",
+    )
+    parser.add_argument(
+        "--code",
+        dest="codes",
+        metavar="CODE",
+        type=int,
+        action="append",
+        help="only show entries with log CODE, can have multiple",
+    )
+
+    parser.add_argument(
+        "-m",
+        "--map",
+        dest="map_file",
+        metavar="FILE",
+        help="name the jobs of job profiles with the application's linker map "
+        "FILE, e.g. obj/map.out. Simulator builds log only the low 32 bits of "
+        "job addresses, so their jobs can't be named",
+    )
+    parser.add_argument(
+        "--job-profile-code",
+        dest="job_profile_code",
+        metavar="CODE",
+        type=parse_user_code,
+        default=JOB_PROFILE_LOG_CODE,
+        help="user error code of job profiles, JOB_PROFILE_LOG_CODE of the build",
+    )
+
+    parser.add_argument(
+        "--batch",
+        dest="batch_dir",
+        metavar="DIR",
+        help="decode all log files in DIR in parallel into the --db database",
+    )
+    parser.add_argument(
+        "--pattern",
+        dest="batch_pattern",
+        metavar="GLOB",
+        default="*.bin",
+        help="file name pattern of log files in --batch mode",
+    )
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        dest="jobs",
+        type=int,
+        default=None,
+        help="number of decoder processes in --batch mode, defaults to CPU count",
+    )
+    parser.add_argument(
+        "--db",
+        dest="database",
+        metavar="FILE",
+        default="logs.sqlite",
+        help="SQLite database with tables 'logs', 'entries' and one per decoded "
+        "log type, e.g. 'watchdog_reset', 'periodic_states_dump'",
+    )
+    parser.add_argument(
+        "--sql",
+        dest="query",
+        metavar="QUERY",
+        help="run QUERY on the --db database and print the result as CSV, e.g. "
+        "\"SELECT module_id, COUNT(*) FROM entries JOIN logs ON logs.id = log_id "
+        "WHERE code = 2 GROUP BY module_id\"",
+    )
+
     parser.add_argument(
         "-d",
         "--default-port",
@@ -458,6 +960,19 @@ def main():
 
     args = parser.parse_args()
 
+    set_decode_options(
+        args.job_profile_code, load_map(args.map_file) if args.map_file else None
+    )
+
+    if args.batch_dir or args.query:
+        if args.batch_dir:
+            batch_decode(
+                args.batch_dir, args.database, args.batch_pattern, args.jobs, sys.stderr
+            )
+        if args.query:
+            query_database(args.database, args.query)
+        sys.exit(0)
+
     port_name = args.portname
     if args.default_port_flag:
         if serial.tools.list_ports.comports():
@@ -487,22 +1002,34 @@ def main():
                 purge_log(serial_port)
         sys.exit(0)
 
+    # Keep status messages out of machine readable output
+    status = sys.stdout if args.output_format == "text" else sys.stderr
+
     if not infile:
         if port_name != "None":
-            print("Using serial port", port_name, args.baud_rate)
+            print("Using serial port", port_name, args.baud_rate, file=status)
             serial_port = capture_bootloader(port_name, args.baud_rate, args.wait_flag)
-            dump = read_log(serial_port)
-            print("Writing log to", outfile)
+            print("Writing log to", outfile, file=status)
             with open(outfile, "wb") as binary_file:
-                binary_file.write(binascii.unhexlify(dump))
-                binary_file.close()
-            infile = outfile
+                stream = read_log(serial_port, binary_file, status)
+                entries = filter_log(
+                    iter_log(stream), args.time_from, args.time_to, args.codes
+                )
+                write_log(entries, args.output_format)
+                stream.drain()
+            serial_port.close()
+            return
 
-    print("Decoding", infile)
+    print("Decoding", infile, file=status)
     with open(infile, "rb") as binary_file:
-        logfile_bytes = bytearray(binary_file.read())
-    log_data = decode_log(logfile_bytes)
-    print(log_to_string(log_data))
+        if args.time_from is None and args.time_to is None and not args.codes:
+            entries = iter_log(binary_file)
+        else:
+            blocks = load_index(infile, binary_file)
+            entries = iter_log_indexed(
+                binary_file, blocks, args.time_from, args.time_to, args.codes
+            )
+        write_log(entries, args.output_format)
 
     if serial_port is not None:
         serial_port.close()
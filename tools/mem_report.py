@@ -0,0 +1,407 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import argparse
+import json
+import os
+import re
+import sys
+
+SECTIONS = [".text", ".rodata", ".data", ".bss"]
+
+# Memory regions each section occupies, .data is copied from flash to RAM
+REGIONS = {
+    "FLASH": [".text", ".rodata", ".data"],
+    "RAM": [".data", ".bss"],
+}
+
+# Output sections whose unnamed input sections count as code
+TEXT_OUTPUT_SECTIONS = (".text", ".ARM.extab", ".ARM.exidx")
+
+memory_re = re.compile(r"^(\w+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+output_re = re.compile(r"^(\.?[\w.]+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?")
+input_re = re.compile(
+    r"^ ([^\s*][^\s]*)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+))?$"
+)
+input_cont_re = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$")
+symbol_re = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_.$][\w.$]*)$")
+
+
+def section_of(input_name, output_name):
+    """Returns which of SECTIONS an input section is counted in, or None"""
+    if input_name == "COMMON" or input_name.startswith(".bss"):
+        return ".bss"
+    for name in (".text", ".rodata", ".data"):
+        if input_name.startswith(name):
+            return name
+    if output_name in TEXT_OUTPUT_SECTIONS:
+        return ".text"
+    if output_name in (".data", ".bss"):
+        return output_name
+    return None
+
+
+def short_object(name):
+    """Strips the directory from archive members and toolchain objects"""
+    match = re.match(r"^(.*\.a)\((.*)\)$", name)
+    if match:
+        return "%s(%s)" % (os.path.basename(match.group(1)), match.group(2))
+    if os.path.isabs(name):
+        return os.path.basename(name)
+    return name
+
+
+def parse_map(stream):
+    """
+    Parses a GNU ld map file. Returns the memory regions as
+    {name: (origin, length)} and the input sections as a list of
+    {"name", "section", "address", "size", "object", "symbols"} where symbols
+    is a list of (address, name).
+    """
+    regions = {}
+    inputs = []
+    in_memory = False
+    in_map = False
+    output_name = None
+    pending = None
+    current = None
+    for line in stream:
+        line = line.rstrip("\n")
+        if line.startswith("Memory Configuration"):
+            in_memory = True
+            continue
+        if line.startswith("Linker script and memory map"):
+            in_memory = False
+            in_map = True
+            continue
+        if in_memory:
+            match = memory_re.match(line)
+            if match and match.group(1) != "Name":
+                regions[match.group(1)] = (
+                    int(match.group(2), 16),
+                    int(match.group(3), 16),
+                )
+            continue
+        if not in_map or not line.strip():
+            continue
+
+        if pending is not None:
+            # Long input section names wrap onto the next line
+            match = input_cont_re.match(line)
+            name, pending = pending, None
+            if match:
+                current = add_input(
+                    inputs,
+                    name,
+                    output_name,
+                    match.group(1),
+                    match.group(2),
+                    match.group(3),
+                )
+                continue
+
+        if not line[0].isspace():
+            match = output_re.match(line)
+            output_name = match.group(1) if match else None
+            current = None
+            continue
+
+        match = input_re.match(line)
+        if match and not match.group(1).startswith(("0x", "KEEP(", "SORT(")):
+            if match.group(2) is None:
+                pending = match.group(1)
+                current = None
+            else:
+                current = add_input(
+                    inputs,
+                    match.group(1),
+                    output_name,
+                    match.group(2),
+                    match.group(3),
+                    match.group(4),
+                )
+            continue
+
+        match = symbol_re.match(line)
+        if match and current is not None:
+            current["symbols"].append((int(match.group(1), 16), match.group(2)))
+        elif line.lstrip().startswith("*"):
+            current = None
+    return regions, inputs
+
+
+def add_input(inputs, name, output_name, address, size, obj):
+    """Appends an input section if it is one the report counts"""
+    section = section_of(name, output_name)
+    size = int(size, 16)
+    if section is None or size == 0:
+        return None
+    entry = {
+        "name": name,
+        "section": section,
+        "address": int(address, 16),
+        "size": size,
+        "object": short_object(obj.strip()),
+        "symbols": [],
+    }
+    inputs.append(entry)
+    return entry
+
+
+def symbol_sizes(entry):
+    """
+    Splits an input section between the symbols it defines. Sections
+    without global symbols are named after the section, which is the
+    function or variable name with -ffunction-sections and -fdata-sections.
+    """
+    end = entry["address"] + entry["size"]
+    symbols = sorted(s for s in entry["symbols"] if s[0] < end)
+    if not symbols:
+        name = entry["name"]
+        for prefix in (entry["section"] + ".", ".text.", ".rodata.", ".data.", ".bss."):
+            if name.startswith(prefix):
+                name = name[len(prefix) :]
+                break
+        return [(name, entry["size"])]
+    sizes = []
+    # Bytes before the first symbol belong to it, e.g. alignment padding
+    for i, (address, name) in enumerate(symbols):
+        next_address = symbols[i + 1][0] if i + 1 < len(symbols) else end
+        start = entry["address"] if i == 0 else address
+        sizes.append((name, next_address - start))
+    return sizes
+
+
+def summarise(regions, inputs):
+    """Returns the totals per section, region, object and symbol"""
+    sections = {name: 0 for name in SECTIONS}
+    objects = {}
+    symbols = {}
+    for entry in inputs:
+        section = entry["section"]
+        sections[section] += entry["size"]
+        sizes = objects.setdefault(entry["object"], {name: 0 for name in SECTIONS})
+        sizes[section] += entry["size"]
+        for name, size in symbol_sizes(entry):
+            key = "%s %s" % (section, name)
+            symbol = symbols.setdefault(
+                key,
+                {
+                    "symbol": name,
+                    "section": section,
+                    "size": 0,
+                    "object": entry["object"],
+                },
+            )
+            symbol["size"] += size
+    used = {
+        region: sum(sections[name] for name in names)
+        for region, names in REGIONS.items()
+    }
+    return {
+        "regions": {
+            region: {"used": used[region], "size": regions.get(region, (0, 0))[1]}
+            for region in REGIONS
+        },
+        "sections": sections,
+        "objects": objects,
+        "symbols": symbols,
+    }
+
+
+def delta_string(value, baseline):
+    if baseline is None:
+        return ""
+    return "%+d" % (value - baseline)
+
+
+def print_report(summary, baseline, top, out=sys.stdout):
+    base_regions = baseline.get("regions", {}) if baseline else {}
+    base_sections = baseline.get("sections", {}) if baseline else {}
+    base_objects = baseline.get("objects", {}) if baseline else {}
+
+    out.write("%-8s %8s %8s %7s %10s\n" % ("Region", "Used", "Size", "Use%", "Delta"))
+    for region, usage in summary["regions"].items():
+        percent = 100.0 * usage["used"] / usage["size"] if usage["size"] else 0
+        base = base_regions.get(region, {}).get("used")
+        out.write(
+            "%-8s %8d %8d %6.1f%% %10s\n"
+            % (
+                region,
+                usage["used"],
+                usage["size"],
+                percent,
+                delta_string(usage["used"], base),
+            )
+        )
+
+    out.write("\n%-8s %8s %10s\n" % ("Section", "Size", "Delta"))
+    for name, size in summary["sections"].items():
+        delta = delta_string(size, base_sections.get(name))
+        out.write("%-8s %8d %10s\n" % (name, size, delta))
+
+    objects = sorted(
+        summary["objects"].items(), key=lambda item: sum(item[1].values()), reverse=True
+    )
+    out.write(
+        "\n%-40s %7s %7s %7s %7s %7s %8s\n"
+        % ("Object", ".text", ".rodata", ".data", ".bss", "Total", "Delta")
+    )
+    for name, sizes in objects[:top]:
+        total = sum(sizes.values())
+        base = base_objects.get(name)
+        if base is not None:
+            base_total = sum(base.values())
+        else:
+            # New objects grow from nothing
+            base_total = 0 if baseline else None
+        out.write(
+            "%-40s %7d %7d %7d %7d %7d %8s\n"
+            % (
+                name[-40:],
+                sizes[".text"],
+                sizes[".rodata"],
+                sizes[".data"],
+                sizes[".bss"],
+                total,
+                delta_string(total, base_total),
+            )
+        )
+
+    symbols = sorted(summary["symbols"].values(), key=lambda s: s["size"], reverse=True)
+    out.write("\n%-40s %-8s %7s  %s\n" % ("Symbol", "Section", "Size", "Object"))
+    for symbol in symbols[:top]:
+        out.write(
+            "%-40s %-8s %7d  %s\n"
+            % (
+                symbol["symbol"][-40:],
+                symbol["section"],
+                symbol["size"],
+                symbol["object"],
+            )
+        )
+
+
+def parse_threshold(value):
+    """Returns (bytes, percent) from "N" or "N%" """
+    if value.endswith("%"):
+        return 0, float(value[:-1])
+    return int(value, 0), 0.0
+
+
+def check_baseline(summary, baseline, threshold):
+    """Returns a list of regions and sections which grew past threshold"""
+    limit_bytes, limit_percent = threshold
+    failures = []
+    current = [("region " + k, v["used"]) for k, v in summary["regions"].items()]
+    current += [("section " + k, v) for k, v in summary["sections"].items()]
+    previous = {
+        "region " + k: v["used"] for k, v in baseline.get("regions", {}).items()
+    }
+    previous.update(
+        {"section " + k: v for k, v in baseline.get("sections", {}).items()}
+    )
+    for name, value in current:
+        if name not in previous:
+            continue
+        growth = value - previous[name]
+        allowed = max(limit_bytes, previous[name] * limit_percent / 100.0)
+        if growth > allowed:
+            failures.append(
+                "%s grew by %d bytes (%d -> %d), threshold %d"
+                % (name, growth, previous[name], value, allowed)
+            )
+    return failures
+
+
+def main():
+    """Implements main CLI entrypoint"""
+    parser = argparse.ArgumentParser(
+        description="Report flash and RAM usage of a user application from its "
+        "linker map, and check it against a stored baseline",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    parser.add_argument("map", help="Linker map file, e.g. obj/map.out")
+    parser.add_argument(
+        "-b", "--baseline", help="Baseline JSON file to compare against"
+    )
+    parser.add_argument(
+        "-u",
+        "--update-baseline",
+        action="store_true",
+        help="Write the current usage to the baseline file instead of checking it",
+    )
+    parser.add_argument(
+        "-t",
+        "--threshold",
+        default="0",
+        help="Allowed growth of each region and section, in bytes or as N%%",
+    )
+    parser.add_argument(
+        "-n",
+        "--top",
+        type=int,
+        default=20,
+        help="Number of objects and symbols to list",
+    )
+    args = parser.parse_args()
+
+    try:
+        threshold = parse_threshold(args.threshold)
+    except ValueError:
+        sys.exit("Invalid threshold %s" % args.threshold)
+
+    with open(args.map, "r") as f:
+        regions, inputs = parse_map(f)
+    if not inputs:
+        sys.exit("No sections found in %s" % args.map)
+    summary = summarise(regions, inputs)
+
+    if args.update_baseline:
+        if not args.baseline:
+            sys.exit("--update-baseline needs --baseline")
+        baseline = {k: summary[k] for k in ("regions", "sections", "objects")}
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print_report(summary, None, args.top)
+        print("\nBaseline written to %s" % args.baseline)
+        return
+
+    baseline = None
+    if args.baseline:
+        try:
+            with open(args.baseline, "r") as f:
+                baseline = json.load(f)
+        except IOError:
+            print(
+                "No baseline %s, run with --update-baseline to create it"
+                % args.baseline
+            )
+    print_report(summary, baseline, args.top)
+
+    if baseline is not None:
+        failures = check_baseline(summary, baseline, threshold)
+        if failures:
+            print("\nMemory usage exceeds the baseline:")
+            for failure in failures:
+                print("  " + failure)
+            sys.exit(1)
+        print("\nMemory usage is within the baseline")
+
+
+if __name__ == "__main__":
+    main()
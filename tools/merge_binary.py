@@ -22,6 +22,7 @@ import signal
 import struct
 import sys
 import tempfile
+import io
 
 file_types = {
     1: "system image",
@@ -30,10 +31,25 @@ file_types = {
     4: "system image part 2",
 }
 
+FILE_TYPE_USER_APP = 2
+# Trailing section listing every other section, skipped by the updater
+FILE_TYPE_INDEX = 0xFF
+
 header_length = (
     16  # header_version(1), reserved(1), type(2), length(4), reserved(6), checksum(2)
 )
 header_version = 0
+header_format = struct.Struct("<BBHIIHH")
+
+# Index entry: offset(4), type(2), reserved(2), length(4), checksum(2),
+# reserved(2), build key(16)
+index_entry = struct.Struct("<IHHIHH16s")
+# Index trailer, the last bytes of the file: magic(4), entry count(4)
+index_trailer = struct.Struct("<4sI")
+index_magic = b"MYIX"
+build_key_length = 16
+
+chunk_size = 64 * 1024
 
 
 def _bytecrc(crc, poly, n):
@@ -48,16 +64,57 @@ def _bytecrc(crc, poly, n):
     return crc
 
 
-def calc_crc(data):
-    poly = 0x11021
-    bit_size = 16
-    table = [_bytecrc(i << (bit_size - 8), poly, bit_size) for i in range(256)]
-    crc = 0
+_crc_table = [_bytecrc(i << 8, 0x11021, 16) for i in range(256)]
+
+
+def calc_crc(data, crc=0):
+    """CRC-16/XMODEM of data, continuing from crc for incremental use"""
+    table = _crc_table
     for b in data:
         crc = table[b ^ ((crc >> 8) & 0xFF)] ^ ((crc << 8) & 0xFF00)
     return crc
 
 
+def read_index(input_file, totalsize):
+    """
+    Returns the list of (offset, type, length, checksum, build key) entries
+    from the trailing index, or None if the file has no index.
+    """
+    if totalsize < header_length + index_trailer.size:
+        return None
+    input_file.seek(totalsize - index_trailer.size)
+    magic, count = index_trailer.unpack(input_file.read(index_trailer.size))
+    if magic != index_magic:
+        return None
+    index_size = count * index_entry.size + index_trailer.size
+    if index_size + header_length > totalsize:
+        return None
+    input_file.seek(totalsize - index_size)
+    entries = []
+    for i in range(count):
+        offset, ftype, _, flen, checksum, _, key = index_entry.unpack(
+            input_file.read(index_entry.size)
+        )
+        entries.append((offset, ftype, flen, checksum, key))
+    return entries
+
+
+def read_section(input_file, offset, ftype, flen, checksum):
+    input_file.seek(offset)
+    data = bytearray(input_file.read(header_length + flen))
+    if len(data) != header_length + flen:
+        sys.stderr.write("Failed to verify file\n")
+        sys.exit(1)
+    _, _, htype, hlen, _, _, hchecksum = header_format.unpack_from(data)
+    data[14] = data[15] = 0
+    if (htype, hlen, hchecksum) != (ftype, flen, checksum) or checksum != (
+        calc_crc(data) & 0xFFFF
+    ):
+        sys.stderr.write("Failed to verify file\n")
+        sys.exit(1)
+    return data[header_length:]
+
+
 def list_extract_file(filename, outfile_name=None, type=None):
     try:
         with open(filename, "rb") as input_file:
@@ -66,11 +123,44 @@ def list_extract_file(filename, outfile_name=None, type=None):
                 sys.stderr.write("File too small\n")
                 sys.exit(1)
 
+            index = read_index(input_file, totalsize)
+            if index is not None:
+                for filenumber, (offset, ftype, flen, checksum, key) in enumerate(
+                    index, 1
+                ):
+                    if outfile_name:
+                        if ftype == type:
+                            data = read_section(
+                                input_file, offset, ftype, flen, checksum
+                            )
+                            with open(outfile_name, "wb") as output_file:
+                                print(
+                                    "Extracting %s, saving to %s."
+                                    % (file_types.get(type), outfile_name)
+                                )
+                                output_file.write(data)
+                            return
+                    else:
+                        print("------- File", filenumber, "-------")
+                        print("Type  :", file_types.get(ftype))
+                        print("Size  :", flen, "bytes")
+                        print("Offset:", offset)
+                        print("CRC   : 0x%04x" % checksum)
+                        if ftype == FILE_TYPE_USER_APP:
+                            print("Key   :", key.hex())
+                        print("")
+                if outfile_name:
+                    print("No %s found!" % file_types.get(type))
+                return
+
+            input_file.seek(0)
             offset = filenumber = 0
             while offset < totalsize:
                 filenumber += 1
                 input_file.seek(2, os.SEEK_CUR)
                 ftype = struct.unpack("<H", input_file.read(2))[0]
+                if ftype == FILE_TYPE_INDEX:
+                    break
                 if not ftype in file_types:
                     sys.stderr.write("File type error\n")
                     sys.exit(1)
@@ -109,28 +199,44 @@ def list_extract_file(filename, outfile_name=None, type=None):
         sys.exit(1)
 
 
+def write_section(outfile, type, input_file, input_size):
+    """
+    Appends a section, computing the checksum while streaming the payload.
+    Returns the index entry of the section.
+    """
+    outfile.seek(0, os.SEEK_END)
+    offset = outfile.tell()
+    header = bytearray(header_format.pack(header_version, 0, type, input_size, 0, 0, 0))
+    outfile.write(header)
+    checksum = calc_crc(header)
+    key = b""
+    remaining = input_size
+    while remaining > 0:
+        chunk = input_file.read(min(chunk_size, remaining))
+        if not chunk:
+            raise IOError("Short read")
+        if len(key) < build_key_length:
+            key += chunk[: build_key_length - len(key)]
+        checksum = calc_crc(chunk, checksum)
+        outfile.write(chunk)
+        remaining -= len(chunk)
+    checksum &= 0xFFFF
+    outfile.seek(offset + 14)
+    outfile.write(struct.pack("<H", checksum))
+    outfile.seek(0, os.SEEK_END)
+    if type != FILE_TYPE_USER_APP:
+        key = b""
+    return (offset, type, input_size, checksum, key)
+
+
 def append_file(infile, outfile, type):
     got_failure = False
+    entry = None
     try:
         with open(infile, "rb") as input_file:
             input_size = os.stat(infile).st_size
             try:
-                outfile.seek(0, os.SEEK_END)
-                outfile.write(struct.pack("<B", header_version))
-                reserved = 0
-                outfile.write(struct.pack("<B", reserved))
-                outfile.write(struct.pack("<H", type))
-                outfile.write(struct.pack("<I", input_size))
-                outfile.write(struct.pack("<I", reserved))
-                checksum = 0
-                outfile.write(struct.pack("<H", reserved))
-                outfile.write(struct.pack("<H", checksum))
-                outfile.write(input_file.read(input_size))
-                outfile.seek(0 - input_size - header_length, os.SEEK_CUR)
-                data = bytearray(outfile.read(input_size + header_length))
-                checksum = calc_crc(data) & 0xFFFF
-                outfile.seek(14 - input_size - header_length, os.SEEK_CUR)
-                outfile.write(struct.pack("<H", checksum))
+                entry = write_section(outfile, type, input_file, input_size)
             except IOError:
                 sys.stderr.write("Failed to write to the output file\n")
                 got_failure = True
@@ -142,8 +248,20 @@ def append_file(infile, outfile, type):
 
     if got_failure:
         sys.exit(1)
-    else:
-        input_file.close()
+    return entry
+
+
+def append_index(outfile, entries):
+    payload = b"".join(
+        index_entry.pack(offset, ftype, 0, flen, checksum, 0, key)
+        for offset, ftype, flen, checksum, key in entries
+    )
+    payload += index_trailer.pack(index_magic, len(entries))
+    try:
+        write_section(outfile, FILE_TYPE_INDEX, io.BytesIO(payload), len(payload))
+    except IOError:
+        sys.stderr.write("Failed to write to the output file\n")
+        sys.exit(1)
 
 
 def signal_handler(signal, frame):
@@ -204,6 +322,14 @@ def main():
         metavar="FILE",
         help="output of merge file",
     )
+    parser.add_argument(
+        "-i",
+        "--index",
+        dest="index_flag",
+        action="store_true",
+        default=False,
+        help="append a section index to the merged file for random access",
+    )
     group.add_argument(
         "-l",
         "--list_contents",
@@ -229,14 +355,17 @@ def main():
     if args.merged_file:
         output_temp = tempfile.NamedTemporaryFile(mode="w+b")
         output_temp_filename = output_temp.name
+        entries = []
         if args.system_filename:
-            append_file(args.system_filename, output_temp, 1)
+            entries.append(append_file(args.system_filename, output_temp, 1))
         if args.application_filename:
-            append_file(args.application_filename, output_temp, 2)
+            entries.append(append_file(args.application_filename, output_temp, 2))
         if args.network_info_filename:
-            append_file(args.network_info_filename, output_temp, 3)
+            entries.append(append_file(args.network_info_filename, output_temp, 3))
         if args.system_filename2:
-            append_file(args.system_filename2, output_temp, 4)
+            entries.append(append_file(args.system_filename2, output_temp, 4))
+        if args.index_flag:
+            append_index(output_temp, entries)
         output_temp.flush()
         shutil.copyfile(output_temp_filename, args.merged_file)
         output_temp.close()
@@ -15,40 +15,140 @@
 
 
 import myriota_auth
+import concurrent.futures
 import json
 import requests
 import sys
+import threading
+import time
+import urllib3
 
 _domain = "https://api.myriota.com/v1"
 
+# HTTP status codes of messages turned away without being injected, so safe
+# to post again. The rest fail straight away.
+RETRY_STATUS = (429, 503)
+RETRY_BACKOFF = 0.5  # seconds, doubled on each retry
+RETRY_BACKOFF_MAX = 30
 
-def do_inject(idtoken, moduleid):
+
+def not_sent(error):
+    """Whether a connection error happened before the request was sent"""
+    if isinstance(error, requests.exceptions.ConnectTimeout):
+        return True
+    reason = getattr(error.args[0], "reason", None) if error.args else None
+    return isinstance(reason, urllib3.exceptions.NewConnectionError)
+
+
+def post_message(session, idtoken, moduleid, message, retries):
+    """
+    Posts one message, retrying with exponential backoff on 429/503 and on
+    failures to connect. Other errors aren't retried as the message may have
+    been injected already.
+    """
+    data = {"TerminalId": moduleid, "Message": message}
+    headers = {
+        "Content-type": "application/json",
+        "Authorization": idtoken,
+    }
+    url = _domain + "/messages"
+    backoff = RETRY_BACKOFF
+    for attempt in range(retries + 1):
+        try:
+            response = session.post(url, data=json.dumps(data), headers=headers)
+        except requests.exceptions.ConnectionError as e:
+            if attempt == retries or not not_sent(e):
+                raise
+            time.sleep(backoff)
+            backoff = min(backoff * 2, RETRY_BACKOFF_MAX)
+            continue
+        if response.status_code not in RETRY_STATUS or attempt == retries:
+            response.raise_for_status()
+            return attempt
+        # Honour the server's hint if it gives one
+        try:
+            delay = float(response.headers.get("Retry-After", backoff))
+        except ValueError:
+            delay = backoff
+        time.sleep(min(delay, RETRY_BACKOFF_MAX))
+        backoff = min(backoff * 2, RETRY_BACKOFF_MAX)
+
+
+def do_inject(idtoken, moduleid, concurrency=8, retries=5, stream=None):
+    """
+    Injects one message per non-empty line of stream, posting up to
+    concurrency messages at a time over a shared keep-alive session.
+    Returns the number of messages that failed.
+    """
+    stream = stream or sys.stdin
     print("Injecting messages from %s..." % moduleid)
-    line = ""
-    while True:
-        ch = sys.stdin.read(1)
-        if ch == "":
-            print("Exiting...")
-            exit(0)
-        line += ch
-        if line.endswith("\n"):
-            if line.strip():
-                message = line.strip().rstrip("\n")
-                print(message)
-                data = {"TerminalId": moduleid, "Message": message}
-                headers = {
-                    "Content-type": "application/json",
-                    "Authorization": idtoken()["IdToken"],
-                }
-                url = _domain + "/messages"
+
+    session = requests.Session()
+    adapter = requests.adapters.HTTPAdapter(
+        pool_connections=1, pool_maxsize=concurrency
+    )
+    session.mount("https://", adapter)
+    session.mount("http://", adapter)
+
+    # Bound the messages in flight so the reader doesn't run ahead of posting
+    in_flight = threading.BoundedSemaphore(concurrency * 2)
+    stats = {"sent": 0, "failed": 0, "retries": 0}
+    lock = threading.Lock()
+
+    def done(future, message):
+        in_flight.release()
+        try:
+            retried = future.result()
+            with lock:
+                stats["sent"] += 1
+                stats["retries"] += retried
+        except requests.exceptions.RequestException as e:
+            with lock:
+                stats["failed"] += 1
+            detail = e
+            if e.response is not None:
                 try:
-                    response = requests.post(
-                        url, data=json.dumps(data), headers=headers
-                    )
-                    response.raise_for_status()
-                except requests.exceptions.RequestException as e:
-                    raise SystemExit(e.response.json())
-            line = ""
+                    detail = e.response.json()
+                except ValueError:
+                    pass
+            sys.stderr.write("Failed to inject %s: %s\n" % (message, detail))
+        except Exception as e:
+            # Anything else is a failed injection too, not a lost message
+            with lock:
+                stats["failed"] += 1
+            sys.stderr.write("Failed to inject %s: %r\n" % (message, e))
+
+    start = time.time()
+    with concurrent.futures.ThreadPoolExecutor(concurrency) as pool:
+        for line in stream:
+            message = line.strip()
+            if not message:
+                continue
+            print(message)
+            in_flight.acquire()
+            future = pool.submit(
+                post_message,
+                session,
+                idtoken()["IdToken"],
+                moduleid,
+                message,
+                retries,
+            )
+            future.add_done_callback(lambda f, m=message: done(f, m))
+    session.close()
+
+    elapsed = max(time.time() - start, 1e-6)
+    print(
+        "Injected %d messages in %.1fs (%.1f messages/s), %d failed, %d retries"
+        % (
+            stats["sent"],
+            elapsed,
+            stats["sent"] / elapsed,
+            stats["failed"],
+            stats["retries"],
+        )
+    )
+    return stats["failed"]
 
 
 def main(argv=None):
@@ -60,18 +160,33 @@ def main(argv=None):
         description='Command line interface for manually injecting message. Messages are input using stdin. Example: echo "1234abcd" | ./message_inject.py <moduleid>'
     )
     parser.add_argument("moduleid", help="Module Id")
+    parser.add_argument(
+        "-c",
+        "--concurrency",
+        type=int,
+        default=8,
+        help="Maximum number of messages posted at the same time",
+    )
+    parser.add_argument(
+        "-r",
+        "--retries",
+        type=int,
+        default=5,
+        help="Maximum number of retries on rate limiting, unavailable server or failures to connect",
+    )
     args = parser.parse_args(argv)
 
+    if args.concurrency <= 0:
+        sys.exit("Invalid concurrency. Must be an integer which is greater than zero")
+
+    # Only check for a refresh token, the ID token comes from the cache
     try:
-        myriota_auth.auth_token(myriota_auth.get_cached_token())
-    except (IOError, ValueError):
+        myriota_auth.get_cached_token()
+    except IOError:
         print("Run myriota_auth.py to generate security token first.")
         return
     idtoken = myriota_auth.auto_auth()
-    try:
-        do_inject(idtoken, args.moduleid)
-    except requests.exceptions.HTTPError as e:
-        print(e)
+    if do_inject(idtoken, args.moduleid, args.concurrency, args.retries):
         sys.exit(1)
 
 
@@ -17,25 +17,89 @@ import sys
 import myriota_auth
 import requests
 import json
+import hashlib
+import os
+import sqlite3
 
 _domain = "https://api.myriota.com/v1"
+CACHE_DIR = os.path.expanduser("~") + "/.cache/myriota/messages"
+SYNC_PAGE_LIMIT = 1000
 
 
-def do_query(idtoken, moduleid, range_from=None, limit=None):
+def do_query(idtoken, moduleid, range_from=None, limit=None, session=requests):
     params = []
-    if range_from:
+    if range_from is not None:
         params.append("from={}".format(range_from))
     if limit:
         params.append("limit={}".format(limit))
 
     url = "?".join(["%s/data/%s/Message" % (_domain, moduleid), "&".join(params)])
-    response = requests.get(url, headers={"Authorization": idtoken})
+    response = session.get(url, headers={"Authorization": idtoken})
 
     response.raise_for_status()
 
     return response.json()["Items"]
 
 
+def open_cache(moduleid, cache_dir=None):
+    """Opens the local message cache of a module"""
+    cache_dir = cache_dir or CACHE_DIR
+    os.makedirs(cache_dir, exist_ok=True)
+    db = sqlite3.connect(os.path.join(cache_dir, "%s.sqlite" % moduleid))
+    db.execute(
+        "CREATE TABLE IF NOT EXISTS messages "
+        "(id TEXT PRIMARY KEY, timestamp INTEGER, item TEXT)"
+    )
+    db.execute("CREATE INDEX IF NOT EXISTS messages_time ON messages (timestamp)")
+    return db
+
+
+def _message_id(item):
+    if "Id" in item:
+        return str(item["Id"])
+    return hashlib.sha1(json.dumps(item, sort_keys=True).encode()).hexdigest()
+
+
+def do_sync(idtoken, moduleid, db, limit=SYNC_PAGE_LIMIT, session=None):
+    """
+    Fetches messages newer than the newest cached one, following pages until
+    no new messages are returned. Returns the number of new messages.
+    """
+    session = session or requests.Session()
+    row = db.execute("SELECT MAX(timestamp) FROM messages").fetchone()
+    # Restart from the newest cached timestamp, duplicates are dropped below
+    range_from = row[0] or 0
+    added = 0
+    while True:
+        items = do_query(idtoken, moduleid, range_from, limit, session)
+        new = 0
+        for item in items:
+            timestamp = int(item.get("Timestamp", 0))
+            cursor = db.execute(
+                "INSERT OR IGNORE INTO messages VALUES (?, ?, ?)",
+                (_message_id(item), timestamp, json.dumps(item)),
+            )
+            new += cursor.rowcount
+            range_from = max(range_from, timestamp)
+        db.commit()
+        added += new
+        if new == 0 or len(items) < limit:
+            return added
+
+
+def cached_query(db, range_from=None, range_to=None, limit=None):
+    query = "SELECT item FROM messages WHERE timestamp >= ?"
+    params = [range_from or 0]
+    if range_to is not None:
+        query += " AND timestamp <= ?"
+        params.append(range_to)
+    query += " ORDER BY timestamp"
+    if limit:
+        query += " LIMIT ?"
+        params.append(limit)
+    return [json.loads(r[0]) for r in db.execute(query, params)]
+
+
 def main(argv=None, auth=myriota_auth.auth):
     """CLI entrypoint."""
     import argparse
@@ -69,10 +133,62 @@ def main(argv=None, auth=myriota_auth.auth):
         help="Maximum number of entries to return",
     )
 
+    sub_parser = subparsers.add_parser(
+        "sync",
+        help="Fetch new messages into the local message cache",
+        description="Fetch messages received since the last sync into the local message cache",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    sub_parser.add_argument("moduleid", help="Module Id")
+    sub_parser.add_argument(
+        "-l",
+        "--limit",
+        type=int,
+        default=SYNC_PAGE_LIMIT,
+        help="Maximum number of entries to fetch per request",
+    )
+    sub_parser.add_argument(
+        "-c", "--cache-dir", default=CACHE_DIR, help="Local message cache directory"
+    )
+
+    sub_parser = subparsers.add_parser(
+        "cached",
+        help="Query the local message cache without contacting Message Store",
+        description="Query the local message cache without contacting Message Store",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    sub_parser.add_argument("moduleid", help="Module Id")
+    sub_parser.add_argument(
+        "-f",
+        "--from",
+        dest="range_from",
+        type=int,
+        default=0,
+        help="Unix epoch second to start query from",
+    )
+    sub_parser.add_argument(
+        "-t",
+        "--to",
+        dest="range_to",
+        type=int,
+        default=None,
+        help="Unix epoch second to end query at",
+    )
+    sub_parser.add_argument(
+        "-l",
+        "--limit",
+        type=int,
+        default=None,
+        help="Maximum number of entries to return, all if not set",
+    )
+    sub_parser.add_argument(
+        "-c", "--cache-dir", default=CACHE_DIR, help="Local message cache directory"
+    )
+
     args = parser.parse_args(argv)
 
     # Validate inputs
-    if args.limit <= 0:
+    if getattr(args, "limit", None) is not None and args.limit <= 0:
         sys.exit("Invalid limit. Must be an integer which is greater than zero")
 
     if args.command == "query":
@@ -83,6 +199,23 @@ def main(argv=None, auth=myriota_auth.auth):
         except requests.exceptions.RequestException as e:
             raise SystemExit(e)
         return json.dumps(items, indent=2)
+    elif args.command == "sync":
+        idtoken = auth()["IdToken"]
+        db = open_cache(args.moduleid, args.cache_dir)
+        try:
+            with requests.Session() as session:
+                added = do_sync(idtoken, args.moduleid, db, args.limit, session)
+        except requests.exceptions.RequestException as e:
+            raise SystemExit(e)
+        total = db.execute("SELECT COUNT(*) FROM messages").fetchone()[0]
+        db.close()
+        return "Synced %d new messages, %d cached" % (added, total)
+    elif args.command == "cached":
+        db = open_cache(args.moduleid, args.cache_dir)
+        range_to = args.range_to * 1000 if args.range_to is not None else None
+        items = cached_query(db, args.range_from * 1000, range_to, args.limit)
+        db.close()
+        return json.dumps(items, indent=2)
     else:
         return "Invalid command"
 
@@ -20,10 +20,20 @@ import requests
 import sys
 import os
 import time
+from contextlib import contextmanager
+
+try:
+    import fcntl
+except ImportError:
+    fcntl = None
 
 CLIENT_ID = "4jskgo1eq6ngcimlseerg50uvd"
 TOKEN_DIR = os.path.expanduser("~") + "/.cache/myriota"
 TOKEN_FILE = TOKEN_DIR + "/token"
+ID_TOKEN_FILE = TOKEN_DIR + "/idtoken"
+LOCK_FILE = TOKEN_DIR + "/lock"
+# Seconds before expiry at which a cached ID token is no longer used
+ID_TOKEN_MARGIN = 300
 
 
 def post(endpoint, args, region="us-east-1"):
@@ -69,9 +79,55 @@ def get_cached_token():
         return f.read().strip()
 
 
+def write_cached_id_token(token, client_id=CLIENT_ID):
+    cached = {k: v for k, v in token.items() if k != "RefreshToken"}
+    cached["ClientId"] = client_id
+    cached["ExpiresAt"] = time.time() + token["ExpiresIn"]
+    if not os.path.exists(TOKEN_DIR):
+        os.makedirs(TOKEN_DIR)
+    # Write to a private file first so readers never see a partial token
+    temp_file = "%s.%d" % (ID_TOKEN_FILE, os.getpid())
+    fd = os.open(temp_file, os.O_WRONLY | os.O_CREAT | os.O_TRUNC, 0o600)
+    with os.fdopen(fd, "w") as f:
+        json.dump(cached, f)
+    os.replace(temp_file, ID_TOKEN_FILE)
+
+
+def get_cached_id_token(client_id=CLIENT_ID):
+    """Returns the cached ID token if it is still valid, None otherwise"""
+    try:
+        with open(ID_TOKEN_FILE, "r") as f:
+            token = json.load(f)
+        remaining = token.pop("ExpiresAt") - time.time()
+        if token.pop("ClientId") != client_id or remaining < ID_TOKEN_MARGIN:
+            return None
+    except (IOError, ValueError, KeyError, TypeError):
+        return None
+    token["ExpiresIn"] = int(remaining)
+    return token
+
+
+@contextmanager
+def token_lock():
+    """Serialises token refreshes across processes"""
+    if fcntl is None:
+        yield
+        return
+    if not os.path.exists(TOKEN_DIR):
+        os.makedirs(TOKEN_DIR)
+    fd = os.open(LOCK_FILE, os.O_RDWR | os.O_CREAT, 0o600)
+    try:
+        fcntl.flock(fd, fcntl.LOCK_EX)
+        yield
+    finally:
+        fcntl.flock(fd, fcntl.LOCK_UN)
+        os.close(fd)
+
+
 def clear_cached_token():
-    if os.path.exists(TOKEN_FILE):
-        os.remove(TOKEN_FILE)
+    for f in (TOKEN_FILE, ID_TOKEN_FILE):
+        if os.path.exists(f):
+            os.remove(f)
 
 
 def auth_user_pass(username, password, client_id=CLIENT_ID):
@@ -100,11 +156,20 @@ def auth_token(token, client_id=CLIENT_ID):
 
 def auth(client_id=CLIENT_ID):
     """Authenticate and return temporary token"""
-    try:
-        return auth_token(get_cached_token(), client_id)
-    except (IOError, ValueError):
-        token = auth_user_pass(get_username(), get_password(), client_id)
-        write_cached_token(token)
+    token = get_cached_id_token(client_id)
+    if token is not None:
+        return token
+    with token_lock():
+        # Another process may have refreshed the token while we waited
+        token = get_cached_id_token(client_id)
+        if token is not None:
+            return token
+        try:
+            token = auth_token(get_cached_token(), client_id)
+        except (IOError, ValueError):
+            token = auth_user_pass(get_username(), get_password(), client_id)
+            write_cached_token(token)
+        write_cached_id_token(token, client_id)
         return token
 
 
@@ -15,13 +15,24 @@
 
 
 import argparse
+import hashlib
 import os
+import re
+import shutil
 import sys
 import requests
 import myriota_auth
+from urllib.parse import quote
 
 __domain = "https://api.myriota.com/v1/release"
 
+CACHE_DIR = os.path.expanduser("~") + "/.cache/myriota/downloads"
+CHUNK_SIZE = 64 * 1024
+
+
+class ChecksumError(Exception):
+    pass
+
 
 def get_download_url(id_token, file_key):
     url = "%s/%s" % (__domain, file_key)
@@ -30,10 +41,119 @@ def get_download_url(id_token, file_key):
     return response.text
 
 
-def download_file(url, output):
-    response = requests.get(url)
-    response.raise_for_status()
-    open(output, "wb").write(response.content)
+def file_sha256(filename):
+    sha256 = hashlib.sha256()
+    with open(filename, "rb") as f:
+        for chunk in iter(lambda: f.read(CHUNK_SIZE), b""):
+            sha256.update(chunk)
+    return sha256.hexdigest()
+
+
+def download_file(url, output, sha256=None):
+    """
+    Streams url to output through output.part, resuming an interrupted
+    download of the same object with an HTTP Range request. The content is
+    checked against the ETag when it is a plain MD5, and against sha256 if
+    given. Returns the SHA-256 of the downloaded file.
+    """
+    partial = output + ".part"
+    etag_file = partial + ".etag"
+    headers = {}
+    offset = 0
+    if os.path.exists(partial) and os.path.exists(etag_file):
+        with open(etag_file, "r") as f:
+            etag = f.read().strip()
+        offset = os.path.getsize(partial)
+        # If-Range makes the server send everything if the object changed
+        headers = {"Range": "bytes=%d-" % offset, "If-Range": etag}
+
+    with requests.get(url, headers=headers, stream=True) as response:
+        if response.status_code == 416:
+            # Nothing left to resume, start over
+            os.remove(partial)
+            os.remove(etag_file)
+            return download_file(url, output, sha256)
+        response.raise_for_status()
+        if response.status_code != 206:
+            offset = 0
+        etag = response.headers.get("ETag")
+        if etag:
+            with open(etag_file, "w") as f:
+                f.write(etag)
+
+        md5 = hashlib.md5()
+        sha = hashlib.sha256()
+        if offset:
+            with open(partial, "rb") as f:
+                for chunk in iter(lambda: f.read(CHUNK_SIZE), b""):
+                    md5.update(chunk)
+                    sha.update(chunk)
+        size = offset
+        with open(partial, "ab" if offset else "wb") as f:
+            for chunk in response.iter_content(CHUNK_SIZE):
+                f.write(chunk)
+                md5.update(chunk)
+                sha.update(chunk)
+                size += len(chunk)
+        length = response.headers.get("Content-Length")
+        if length is not None and size != offset + int(length):
+            # Keep the partial file to resume from next time
+            raise requests.exceptions.ConnectionError(
+                "Download interrupted at %d of %d bytes" % (size, offset + int(length))
+            )
+
+    # Multipart upload ETags aren't an MD5 of the content
+    plain_etag = etag.strip('"') if etag else ""
+    failed = None
+    if re.match(r"^[0-9a-f]{32}$", plain_etag) and md5.hexdigest() != plain_etag:
+        failed = "MD5 %s, expected %s" % (md5.hexdigest(), plain_etag)
+    elif sha256 and sha.hexdigest() != sha256.lower():
+        failed = "SHA-256 %s, expected %s" % (sha.hexdigest(), sha256)
+    if failed:
+        for f in (partial, etag_file):
+            if os.path.exists(f):
+                os.remove(f)
+        raise ChecksumError(failed)
+
+    os.replace(partial, output)
+    if os.path.exists(etag_file):
+        os.remove(etag_file)
+    return sha.hexdigest()
+
+
+def _cache_key_file(cache_dir, file_key):
+    return os.path.join(cache_dir, "keys", quote(file_key, safe=""))
+
+
+def cache_lookup(cache_dir, file_key, sha256=None):
+    """Returns the cached object of file_key if present and intact"""
+    try:
+        with open(_cache_key_file(cache_dir, file_key), "r") as f:
+            digest = f.read().strip()
+    except IOError:
+        return None
+    if sha256 and digest != sha256.lower():
+        return None
+    cached = os.path.join(cache_dir, "objects", digest)
+    if not os.path.exists(cached) or file_sha256(cached) != digest:
+        return None
+    return cached
+
+
+def cached_download(url, cache_dir, file_key, sha256=None):
+    """
+    Downloads file_key into the content-addressed cache and returns the path
+    of the cached object. Interrupted downloads resume on the next call.
+    """
+    for d in ("keys", "objects", "partial"):
+        os.makedirs(os.path.join(cache_dir, d), exist_ok=True)
+    partial = os.path.join(cache_dir, "partial", quote(file_key, safe=""))
+    digest = download_file(url, partial, sha256)
+    cached = os.path.join(cache_dir, "objects", digest)
+    os.replace(partial, cached)
+    with open(_cache_key_file(cache_dir, file_key), "w") as f:
+        f.write(digest)
+    return cached
 
 
 def main(argv=None):
@@ -51,6 +171,26 @@ def main(argv=None):
         required=False,
         help="Output to this file instead of the filename in the current directory",
     )
+    parser.add_argument(
+        "-s",
+        "--sha256",
+        type=str,
+        default=None,
+        help="Expected SHA-256 of the file",
+    )
+    parser.add_argument(
+        "-c",
+        "--cache-dir",
+        type=str,
+        default=CACHE_DIR,
+        help="Local download cache directory",
+    )
+    parser.add_argument(
+        "-n",
+        "--no-cache",
+        action="store_true",
+        help="Always download the file, bypassing the local cache",
+    )
     args = parser.parse_args(argv)
 
     # If output is not provided, use the original filename
@@ -59,10 +199,20 @@ def main(argv=None):
     else:
         output = args.output
 
+    if not args.no_cache:
+        cached = cache_lookup(args.cache_dir, args.filename, args.sha256)
+        if cached is not None:
+            shutil.copyfile(cached, output)
+            return
+
     try:
         token = myriota_auth.auth()["IdToken"]
         s3_url = get_download_url(token, args.filename)
-        download_file(s3_url, output)
+        if args.no_cache:
+            download_file(s3_url, output, args.sha256)
+        else:
+            cached = cached_download(s3_url, args.cache_dir, args.filename, args.sha256)
+            shutil.copyfile(cached, output)
     # Handle http errors from s3 download
     except requests.exceptions.HTTPError as e:
         if e.response.status_code >= 500:
@@ -74,6 +224,9 @@ def main(argv=None):
     except requests.exceptions.RequestException as e:
         print(e)
         sys.exit(1)
+    except ChecksumError as e:
+        print("Checksum mismatch:", e)
+        sys.exit(3)
 
 
 if __name__ == "__main__":
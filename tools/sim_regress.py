@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import argparse
+import concurrent.futures
+import difflib
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+STARTTIME = 1672531200
+LATITUDE = "-34.9251188"
+LONGITUDE = "138.600888"
+DURATION = 24 * 3600
+
+TIMING_FILE = "timing.json"
+# Runs this much slower than the golden timing are still fine, in seconds
+TIMING_SLACK = 0.5
+
+_program_name_mk = "print-program-name:\n\t@echo $(PROGRAM_NAME)\n"
+
+
+def golden_name(example):
+    return example.strip("/").replace("/", "_")
+
+
+def program_path(example, make_args):
+    """Returns the simulator binary the example's Makefile builds"""
+    with tempfile.NamedTemporaryFile("w", suffix=".mk", delete=False) as f:
+        f.write(_program_name_mk)
+    try:
+        output = subprocess.check_output(
+            ["make", "-s", "--no-print-directory", "-C", example]
+            + ["-f", "Makefile", "-f", f.name, "print-program-name"]
+            + make_args,
+            universal_newlines=True,
+        )
+    finally:
+        os.remove(f.name)
+    return os.path.join(example, output.strip().splitlines()[-1])
+
+
+def normalise(output, pid, ignore):
+    """Drops the lines that change from run to run"""
+    lines = []
+    for line in output.splitlines():
+        if ignore and ignore.search(line):
+            continue
+        lines.append(re.sub(r"\b%d\b" % pid, "<pid>", line))
+    return lines
+
+
+def run_example(example, args, ignore):
+    """Runs one example in the simulator. Returns (lines, elapsed, error)"""
+    try:
+        program = program_path(example, args.make_arg)
+    except (OSError, subprocess.CalledProcessError) as e:
+        return None, 0, "failed to find program: %s" % e
+    if not os.access(program, os.X_OK):
+        return None, 0, "%s not built" % program
+
+    env = dict(os.environ)
+    env.update(
+        {
+            "STARTTIME": str(args.starttime),
+            "LATITUDE": args.latitude,
+            "LONGITUDE": args.longitude,
+            "SIMDURATION": str(args.duration),
+        }
+    )
+    start = time.time()
+    try:
+        process = subprocess.Popen(
+            [os.path.abspath(program)],
+            cwd=example,
+            env=env,
+            stdin=subprocess.DEVNULL,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            universal_newlines=True,
+        )
+        output, _ = process.communicate(timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        process.kill()
+        process.communicate()
+        return None, time.time() - start, "timed out after %ds" % args.timeout
+    elapsed = time.time() - start
+    lines = normalise(output, process.pid, ignore)
+    if process.returncode != 0:
+        return lines, elapsed, "exited with %d" % process.returncode
+    return lines, elapsed, None
+
+
+def main():
+    """Implements main CLI entrypoint"""
+    parser = argparse.ArgumentParser(
+        description="Run examples in the simulator for a fixed simulated period "
+        "and compare their output and run time with golden files",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    parser.add_argument(
+        "examples", nargs="+", help="Example directories, already built"
+    )
+    parser.add_argument("-g", "--golden", required=True, help="Golden file directory")
+    parser.add_argument(
+        "-u",
+        "--update",
+        action="store_true",
+        help="Write the golden files from this run instead of comparing",
+    )
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--starttime", type=int, default=STARTTIME)
+    parser.add_argument("--latitude", default=LATITUDE)
+    parser.add_argument("--longitude", default=LONGITUDE)
+    parser.add_argument(
+        "-d", "--duration", type=int, default=DURATION, help="Simulated seconds"
+    )
+    parser.add_argument(
+        "-t", "--timeout", type=int, default=600, help="Wall clock limit per example"
+    )
+    parser.add_argument(
+        "--time-tolerance",
+        type=float,
+        default=50,
+        help="Allowed run time increase over the golden timing in percent",
+    )
+    parser.add_argument("--ignore", help="Regex of output lines to leave out")
+    parser.add_argument(
+        "-m",
+        "--make-arg",
+        action="append",
+        default=[],
+        help="Argument passed to make when looking up the program name",
+    )
+    args = parser.parse_args()
+
+    ignore = re.compile(args.ignore) if args.ignore else None
+    timing_file = os.path.join(args.golden, TIMING_FILE)
+    try:
+        with open(timing_file, "r") as f:
+            timing = json.load(f)
+    except IOError:
+        timing = {}
+
+    with concurrent.futures.ThreadPoolExecutor(args.jobs) as pool:
+        futures = {e: pool.submit(run_example, e, args, ignore) for e in args.examples}
+        results = {e: f.result() for e, f in futures.items()}
+
+    failed = []
+    print("%-36s %8s %8s  %s" % ("Example", "Time", "Golden", "Result"))
+    for example in args.examples:
+        lines, elapsed, error = results[example]
+        name = golden_name(example)
+        golden_file = os.path.join(args.golden, name + ".out")
+        golden_time = timing.get(name)
+        golden_time_str = "%.2f" % golden_time if golden_time is not None else "-"
+
+        if error:
+            failed.append(example)
+            print("%-36s %8.2f %8s  %s" % (example, elapsed, golden_time_str, error))
+            continue
+        if args.update:
+            os.makedirs(args.golden, exist_ok=True)
+            with open(golden_file, "w") as f:
+                f.write("\n".join(lines) + "\n")
+            timing[name] = round(elapsed, 3)
+            print("%-36s %8.2f %8s  updated" % (example, elapsed, golden_time_str))
+            continue
+        if not os.path.exists(golden_file):
+            failed.append(example)
+            print(
+                "%-36s %8.2f %8s  %s"
+                % (example, elapsed, golden_time_str, "no golden file, run with -u")
+            )
+            continue
+
+        with open(golden_file, "r") as f:
+            golden = f.read().splitlines()
+        problems = []
+        if lines != golden:
+            problems.append("output differs")
+        if golden_time is not None:
+            limit = golden_time * (1 + args.time_tolerance / 100.0) + TIMING_SLACK
+            if elapsed > limit:
+                problems.append("slower than %.2fs" % limit)
+        print(
+            "%-36s %8.2f %8s  %s"
+            % (example, elapsed, golden_time_str, ", ".join(problems) or "ok")
+        )
+        if problems:
+            failed.append(example)
+        if lines != golden:
+            diff = difflib.unified_diff(
+                golden, lines, golden_file, "output", lineterm=""
+            )
+            for i, line in enumerate(diff):
+                if i == 40:
+                    print("    ...")
+                    break
+                print("    " + line)
+
+    if args.update:
+        with open(timing_file, "w") as f:
+            json.dump(timing, f, indent=2, sort_keys=True)
+            f.write("\n")
+    if failed:
+        print("\n%d of %d examples failed" % (len(failed), len(args.examples)))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
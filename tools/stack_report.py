@@ -0,0 +1,318 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# Instructions which transfer control to their relocation target
+CALL_MNEMONICS = ("bl", "blx", "b", "b.w", "b.n", "call", "callq", "jmp", "jmpq")
+
+function_re = re.compile(r"^[0-9a-fA-F]+ <([^>]+)>:$")
+instruction_re = re.compile(
+    r"^\s+[0-9a-fA-F]+:\s+(?:[0-9a-fA-F]{2,8} )+\s*(\S+)\s*(.*)$"
+)
+relocation_re = re.compile(r"^\s+[0-9a-fA-F]+: (R_\w+)\s+([^\s+-]+)")
+data_relocation_re = re.compile(r"^[0-9a-fA-F]+\s+(R_\w+)\s+([^\s+-]+)")
+relocation_section_re = re.compile(r"^RELOCATION RECORDS FOR \[(.*)\]:$")
+indirect_re = re.compile(r"^(?:blx?\s+r\d+|bx\s+r\d+|call[q]?\s+\*|jmp[q]?\s+\*)")
+schedule_job_re = re.compile(r"\bScheduleJob\s*\(\s*([A-Za-z_]\w*)\s*,")
+
+
+class Function:
+    def __init__(self, name, obj):
+        self.name = name
+        self.obj = obj
+        self.frame = None  # None when there is no .su entry
+        self.dynamic = False
+        self.calls = set()
+        self.indirect = False
+
+
+def read_stack_usage(su_file):
+    """
+    Reads a GCC -fstack-usage file. Returns {function: (bytes, dynamic)}.
+    Lines look like "main.c:12:6:AppInit<TAB>16<TAB>static".
+    """
+    usage = {}
+    with open(su_file, "r") as f:
+        for line in f:
+            fields = line.rstrip("\n").split("\t")
+            if len(fields) < 3:
+                continue
+            name = fields[0].rsplit(":", 1)[-1]
+            usage[name] = (int(fields[1]), fields[2] != "static")
+    return usage
+
+
+def relocation_target(symbol):
+    # References to static functions may go through the section symbol
+    if symbol.startswith(".text."):
+        return symbol[len(".text.") :]
+    return symbol
+
+
+def read_calls(objdump, obj):
+    """
+    Disassembles obj with its relocations. Returns ({function: (callees,
+    indirect)}, referenced) where indirect is set when the function calls
+    through a register, and referenced holds every symbol used other than
+    as a call target, i.e. the candidates for those indirect calls.
+    """
+    output = subprocess.check_output([objdump, "-dr", obj], universal_newlines=True)
+    calls = {}
+    referenced = set()
+    current = None
+    mnemonic = None
+    for line in output.splitlines():
+        match = function_re.match(line)
+        if match:
+            current = calls.setdefault(match.group(1), (set(), [False]))
+            mnemonic = None
+            continue
+        if current is None:
+            continue
+        match = relocation_re.match(line)
+        if match:
+            if mnemonic in CALL_MNEMONICS:
+                current[0].add(relocation_target(match.group(2)))
+            else:
+                referenced.add(relocation_target(match.group(2)))
+            continue
+        match = instruction_re.match(line)
+        if match:
+            mnemonic = match.group(1)
+            if indirect_re.match("%s %s" % (mnemonic, match.group(2))):
+                current[1][0] = True
+
+    # Function pointer tables live in the data sections, which -d skips
+    output = subprocess.check_output([objdump, "-r", obj], universal_newlines=True)
+    section = ""
+    for line in output.splitlines():
+        match = relocation_section_re.match(line)
+        if match:
+            section = match.group(1)
+            continue
+        match = data_relocation_re.match(line)
+        if match and re.match(r"^\.(rel\.|rela\.)?(data|rodata)", section):
+            referenced.add(relocation_target(match.group(2)))
+
+    calls = {
+        name: (callees, indirect[0]) for name, (callees, indirect) in calls.items()
+    }
+    return calls, referenced
+
+
+def find_jobs(sources):
+    """Returns the functions passed to ScheduleJob in sources"""
+    jobs = []
+    for source in sources:
+        try:
+            with open(source, "r") as f:
+                text = f.read()
+        except IOError:
+            continue
+        # Drop comments so commented out jobs aren't reported
+        text = re.sub(r"/\*.*?\*/|//[^\n]*", "", text, flags=re.S)
+        for job in schedule_job_re.findall(text):
+            if job not in jobs:
+                jobs.append(job)
+    return jobs
+
+
+def load_functions(objdump, objects):
+    """
+    Returns the functions of objects keyed by (object, name). An indirect
+    call is assumed to reach any function whose address is taken in the
+    same object, which covers the usual static handler table.
+    """
+    functions = {}
+    for obj in objects:
+        su_file = os.path.splitext(obj)[0] + ".su"
+        usage = read_stack_usage(su_file) if os.path.exists(su_file) else {}
+        calls, referenced = read_calls(objdump, obj)
+        address_taken = referenced & set(calls)
+        for name, (callees, indirect) in calls.items():
+            function = Function(name, obj)
+            # .su files drop the number from clones such as foo.isra.0
+            su_name = name if name in usage else re.sub(r"\.\d+$", "", name)
+            if su_name in usage:
+                function.frame, function.dynamic = usage[su_name]
+            function.calls = set(callees)
+            function.indirect = indirect
+            if indirect:
+                function.calls |= address_taken
+            functions[(obj, name)] = function
+    return functions
+
+
+def worst_case(functions, root, unknown_frame):
+    """
+    Walks the call graph from root. Returns (depth, path, notes, external)
+    where path is the list of (function, frame) on the deepest call chain,
+    notes lists what makes the depth a lower bound and external the called
+    functions outside the objects, e.g. the SDK and C library, which count
+    as unknown_frame bytes.
+    """
+    by_name = {}
+    for (obj, name), function in functions.items():
+        by_name.setdefault(name, []).append(function)
+
+    def resolve(name, caller_obj):
+        candidates = by_name.get(name, [])
+        for function in candidates:
+            if function.obj == caller_obj:
+                return function
+        return candidates[0] if candidates else None
+
+    notes = set()
+    external = set()
+    memo = {}
+
+    def walk(function, stack):
+        key = (function.obj, function.name)
+        if key in memo:
+            return memo[key]
+        if key in stack:
+            notes.add("recursion through %s" % function.name)
+            return 0, []
+        frame = function.frame
+        if frame is None:
+            notes.add("no stack usage for %s" % function.name)
+            frame = unknown_frame
+        if function.dynamic:
+            notes.add("dynamic stack in %s" % function.name)
+        if function.indirect:
+            notes.add("indirect call in %s" % function.name)
+        deepest, deepest_path = 0, []
+        for callee_name in sorted(function.calls):
+            callee = resolve(callee_name, function.obj)
+            if callee is None:
+                external.add(callee_name)
+                depth, path = unknown_frame, [(callee_name, None)]
+            else:
+                depth, path = walk(callee, stack | {key})
+            if depth > deepest:
+                deepest, deepest_path = depth, path
+        result = (frame + deepest, [(function.name, function.frame)] + deepest_path)
+        memo[key] = result
+        return result
+
+    function = resolve(root, None)
+    if function is None:
+        return None, [], set(), set()
+    depth, path = walk(function, frozenset())
+    return depth, path, notes, external
+
+
+def main():
+    """Implements main CLI entrypoint"""
+    parser = argparse.ArgumentParser(
+        description="Report the worst-case stack depth of each scheduled job "
+        "from objects built with -fstack-usage",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    parser.add_argument("objects", nargs="+", help="Object files, with .su files")
+    parser.add_argument(
+        "-s",
+        "--source",
+        action="append",
+        default=[],
+        help="Source file to search for ScheduleJob calls, may be repeated",
+    )
+    parser.add_argument(
+        "-e",
+        "--entry",
+        action="append",
+        default=[],
+        help="Additional entry point to report, may be repeated",
+    )
+    parser.add_argument(
+        "--objdump", default="objdump", help="objdump to disassemble with"
+    )
+    parser.add_argument(
+        "-u",
+        "--unknown",
+        type=int,
+        default=0,
+        help="Stack bytes assumed for functions without usage, e.g. SDK calls",
+    )
+    parser.add_argument(
+        "-f",
+        "--frame",
+        type=int,
+        default=256,
+        help="List single frames of at least this many bytes",
+    )
+    parser.add_argument(
+        "-l",
+        "--limit",
+        type=int,
+        default=0,
+        help="Fail if any entry point needs more than this many bytes, 0 to disable",
+    )
+    args = parser.parse_args()
+
+    try:
+        functions = load_functions(args.objdump, args.objects)
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit("Failed to disassemble: %s" % e)
+
+    entries = args.entry + [j for j in find_jobs(args.source) if j not in args.entry]
+    over_limit = []
+    print("%-32s %8s  %s" % ("Entry", "Stack", "Deepest call chain"))
+    for entry in entries:
+        depth, path, notes, external = worst_case(functions, entry, args.unknown)
+        if depth is None:
+            print("%-32s %8s  not found" % (entry, "-"))
+            continue
+        chain = " > ".join(
+            "%s(%s)" % (name, "?" if frame is None else frame) for name, frame in path
+        )
+        bound = "+" if notes or external else " "
+        print("%-32s %7d%s  %s" % (entry, depth, bound, chain))
+        for note in sorted(notes):
+            print("%-32s %8s    %s" % ("", "", note))
+        if external:
+            print("%-32s %8s    external: %s" % ("", "", ", ".join(sorted(external))))
+        if args.limit and depth > args.limit:
+            over_limit.append((entry, depth))
+
+    large = sorted(
+        (
+            f
+            for f in functions.values()
+            if f.frame is not None and f.frame >= args.frame
+        ),
+        key=lambda f: f.frame,
+        reverse=True,
+    )
+    if large:
+        print("\n%-32s %8s  %s" % ("Large frame", "Stack", "Object"))
+        for function in large:
+            print("%-32s %8d  %s" % (function.name, function.frame, function.obj))
+
+    if over_limit:
+        print("\nStack limit of %d bytes exceeded:" % args.limit)
+        for entry, depth in over_limit:
+            print("  %s needs %d bytes" % (entry, depth))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
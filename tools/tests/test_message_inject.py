@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Tests message_inject.py retries against a local stand-in for the messages
+# API. Run with python3 -m unittest discover -s tools/tests
+
+import contextlib
+import http.server
+import io
+import json
+import os
+import socket
+import sys
+import threading
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+
+import message_inject  # noqa: E402
+import requests  # noqa: E402
+
+
+class MessagesHandler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def do_POST(self):
+        data = json.loads(self.rfile.read(int(self.headers["Content-Length"])))
+        message = data["Message"]
+        with self.server.lock:
+            self.server.posts.append(message)
+            # Responses queued for the message, then 200
+            responses = self.server.responses.get(message, [])
+            status, headers = responses.pop(0) if responses else (200, {})
+        body = json.dumps({"Message": message}).encode()
+        self.send_response(status)
+        for name, value in headers.items():
+            self.send_header(name, value)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, *args):
+        pass
+
+
+def closed_port():
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+class InjectTest(unittest.TestCase):
+    def setUp(self):
+        self.server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), MessagesHandler)
+        self.server.lock = threading.Lock()
+        self.server.posts = []
+        self.server.responses = {}
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+        self.saved = (message_inject._domain, message_inject.RETRY_BACKOFF)
+        message_inject._domain = "http://127.0.0.1:%d/v1" % self.server.server_port
+        message_inject.RETRY_BACKOFF = 0.01
+        self.session = requests.Session()
+
+    def tearDown(self):
+        self.session.close()
+        message_inject._domain, message_inject.RETRY_BACKOFF = self.saved
+        self.server.shutdown()
+        self.server.server_close()
+
+    def post(self, message, retries=5):
+        return message_inject.post_message(
+            self.session, "token", "0012345678", message, retries
+        )
+
+    def inject(self, messages, retries=5):
+        stream = io.StringIO("".join(m + "\n" for m in messages))
+        out = io.StringIO()
+        with contextlib.redirect_stdout(out), contextlib.redirect_stderr(out):
+            failed = message_inject.do_inject(
+                lambda: {"IdToken": "token"}, "0012345678", 4, retries, stream
+            )
+        return failed, out.getvalue()
+
+    def test_retries_429_and_503(self):
+        self.server.responses["01"] = [(429, {}), (503, {"Retry-After": "0"})]
+        self.assertEqual(self.post("01"), 2)
+        self.assertEqual(self.server.posts, ["01", "01", "01"])
+
+    def test_gives_up_after_retries(self):
+        self.server.responses["02"] = [(503, {})] * 3
+        with self.assertRaises(requests.exceptions.HTTPError) as e:
+            self.post("02", retries=2)
+        self.assertEqual(e.exception.response.status_code, 503)
+        self.assertEqual(len(self.server.posts), 3)
+
+    def test_other_errors_not_retried(self):
+        self.server.responses["03"] = [(500, {})]
+        with self.assertRaises(requests.exceptions.HTTPError):
+            self.post("03")
+        self.assertEqual(self.server.posts, ["03"])
+
+    def test_not_sent(self):
+        url = "http://127.0.0.1:%d/v1/messages" % closed_port()
+        with self.assertRaises(requests.exceptions.ConnectionError) as e:
+            self.session.post(url, data="{}")
+        self.assertTrue(message_inject.not_sent(e.exception))
+        self.assertTrue(
+            message_inject.not_sent(requests.exceptions.ConnectTimeout("timeout"))
+        )
+        self.assertFalse(
+            message_inject.not_sent(requests.exceptions.ReadTimeout("timeout"))
+        )
+        self.assertFalse(message_inject.not_sent(requests.exceptions.ConnectionError()))
+
+    def test_connection_refused_retried(self):
+        message_inject._domain = "http://127.0.0.1:%d/v1" % closed_port()
+        attempts = []
+        post = self.session.post
+
+        def counted(*args, **kwargs):
+            attempts.append(args[0])
+            return post(*args, **kwargs)
+
+        self.session.post = counted
+        with self.assertRaises(requests.exceptions.ConnectionError):
+            self.post("04", retries=2)
+        self.assertEqual(len(attempts), 3)
+
+    def test_inject_counts_failures(self):
+        self.server.responses["05"] = [(429, {})]
+        self.server.responses["06"] = [(400, {})]
+        failed, out = self.inject(["05", "06", "07"])
+        self.assertEqual(failed, 1)
+        self.assertIn("Failed to inject 06", out)
+        self.assertIn("Injected 2 messages", out)
+        self.assertIn("1 retries", out)
+
+    def test_inject_unexpected_error_fails(self):
+        post_message = message_inject.post_message
+
+        def broken(*args):
+            raise ValueError("unexpected")
+
+        message_inject.post_message = broken
+        try:
+            failed, out = self.inject(["08", "09"])
+        finally:
+            message_inject.post_message = post_message
+        self.assertEqual(failed, 2)
+        self.assertIn("Failed to inject 08: ValueError('unexpected')", out)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Tests message_store.py sync against a local stand-in for Message Store.
+# Run with python3 -m unittest discover -s tools/tests
+
+import http.server
+import json
+import os
+import sys
+import tempfile
+import threading
+import unittest
+import urllib.parse
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+
+import message_store  # noqa: E402
+
+
+class MessageStoreHandler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def do_GET(self):
+        url = urllib.parse.urlparse(self.path)
+        query = urllib.parse.parse_qs(url.query)
+        self.server.requests.append((url.path, query))
+        range_from = int(query.get("from", ["0"])[0])
+        limit = int(query.get("limit", ["100"])[0])
+        items = [m for m in self.server.messages if m["Timestamp"] >= range_from]
+        body = json.dumps({"Items": items[:limit]}).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, *args):
+        pass
+
+
+def message(i):
+    # Two messages per second, as Message Store returns them
+    return {"Id": "m%d" % i, "Timestamp": 1000 * (1700000000 + i // 2), "Value": i}
+
+
+class SyncTest(unittest.TestCase):
+    def setUp(self):
+        self.server = http.server.ThreadingHTTPServer(
+            ("127.0.0.1", 0), MessageStoreHandler
+        )
+        self.server.messages = [message(i) for i in range(7)]
+        self.server.requests = []
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+        self.domain = message_store._domain
+        message_store._domain = "http://127.0.0.1:%d/v1" % self.server.server_port
+        self.cache_dir = tempfile.TemporaryDirectory()
+        self.db = message_store.open_cache("0012345678", self.cache_dir.name)
+
+    def tearDown(self):
+        self.db.close()
+        self.cache_dir.cleanup()
+        message_store._domain = self.domain
+        self.server.shutdown()
+        self.server.server_close()
+
+    def sync(self):
+        self.server.requests = []
+        return message_store.do_sync("token", "0012345678", self.db, limit=3)
+
+    def cached_ids(self):
+        return [m["Id"] for m in message_store.cached_query(self.db)]
+
+    def test_first_sync_pages_from_zero(self):
+        self.assertEqual(self.sync(), 7)
+        self.assertEqual(self.cached_ids(), ["m%d" % i for i in range(7)])
+        path, query = self.server.requests[0]
+        self.assertEqual(path, "/v1/data/0012345678/Message")
+        self.assertEqual(query["from"], ["0"])
+        self.assertEqual(query["limit"], ["3"])
+        # Each page restarts from the newest timestamp of the previous one
+        self.assertEqual(
+            [q["from"][0] for _, q in self.server.requests[1:]],
+            [str(message(i)["Timestamp"]) for i in (2, 4, 6)],
+        )
+
+    def test_sync_resumes_from_newest_cached(self):
+        self.sync()
+        self.server.messages += [message(i) for i in range(7, 12)]
+        self.assertEqual(self.sync(), 5)
+        self.assertEqual(self.cached_ids(), ["m%d" % i for i in range(12)])
+        _, query = self.server.requests[0]
+        self.assertEqual(query["from"], [str(message(6)["Timestamp"])])
+
+    def test_sync_without_new_messages(self):
+        self.sync()
+        self.assertEqual(self.sync(), 0)
+        self.assertEqual(len(self.server.requests), 1)
+        self.assertEqual(len(self.cached_ids()), 7)
+
+
+if __name__ == "__main__":
+    unittest.main()
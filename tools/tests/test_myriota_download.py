@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Tests myriota_download.py resumable downloads against a local stand-in for
+# the release bucket. Run with python3 -m unittest discover -s tools/tests
+
+import hashlib
+import http.server
+import os
+import socket
+import sys
+import tempfile
+import threading
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+
+import myriota_download  # noqa: E402
+import requests  # noqa: E402
+
+
+def md5_etag(data):
+    return '"%s"' % hashlib.md5(data).hexdigest()
+
+
+class BucketHandler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def do_GET(self):
+        server = self.server
+        server.requests.append(
+            (self.headers.get("Range"), self.headers.get("If-Range"))
+        )
+        start = 0
+        if self.headers.get("Range") and self.headers.get("If-Range") == server.etag:
+            start = int(self.headers["Range"].split("=")[1].rstrip("-"))
+            if start >= len(server.data):
+                self.send_response(416)
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+                return
+            self.send_response(206)
+        else:
+            self.send_response(200)
+        body = server.data[start:]
+        self.send_header("ETag", server.etag)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        if server.cut is not None:
+            # Drop the connection part way through the body
+            self.wfile.write(body[: server.cut])
+            self.wfile.flush()
+            server.cut = None
+            self.close_connection = True
+            self.connection.shutdown(socket.SHUT_RDWR)
+            return
+        self.wfile.write(body)
+
+    def log_message(self, *args):
+        pass
+
+
+class DownloadTest(unittest.TestCase):
+    def setUp(self):
+        self.server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), BucketHandler)
+        self.serve(os.urandom(300000))
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+        self.url = "http://127.0.0.1:%d/system_image.bin" % self.server.server_port
+        self.dir = tempfile.TemporaryDirectory()
+        self.output = os.path.join(self.dir.name, "system.img")
+        self.partial = self.output + ".part"
+        self.etag_file = self.partial + ".etag"
+
+    def tearDown(self):
+        self.dir.cleanup()
+        self.server.shutdown()
+        self.server.server_close()
+
+    def serve(self, data, etag=None, cut=None):
+        self.server.data = data
+        self.server.etag = etag or md5_etag(data)
+        self.server.cut = cut
+        self.server.requests = []
+
+    def download(self, sha256=None):
+        return myriota_download.download_file(self.url, self.output, sha256)
+
+    def read(self, filename):
+        with open(filename, "rb") as f:
+            return f.read()
+
+    def test_download(self):
+        data = self.server.data
+        self.assertEqual(self.download(), hashlib.sha256(data).hexdigest())
+        self.assertEqual(self.read(self.output), data)
+        self.assertFalse(os.path.exists(self.partial))
+        self.assertFalse(os.path.exists(self.etag_file))
+        self.assertEqual(self.server.requests, [(None, None)])
+
+    def test_resume_after_interruption(self):
+        data = self.server.data
+        self.server.cut = 100000
+        with self.assertRaises(requests.exceptions.RequestException):
+            self.download()
+        self.assertFalse(os.path.exists(self.output))
+        # Whole chunks received before the connection dropped are kept
+        received = self.read(self.partial)
+        self.assertGreater(len(received), 0)
+        self.assertEqual(received, data[: len(received)])
+        self.assertEqual(self.read(self.etag_file).decode(), self.server.etag)
+
+        self.server.requests = []
+        self.assertEqual(self.download(), hashlib.sha256(data).hexdigest())
+        self.assertEqual(
+            self.server.requests, [("bytes=%d-" % len(received), self.server.etag)]
+        )
+        self.assertEqual(self.read(self.output), data)
+        self.assertFalse(os.path.exists(self.partial))
+        self.assertFalse(os.path.exists(self.etag_file))
+
+    def test_restart_when_object_changed(self):
+        self.server.cut = 100000
+        with self.assertRaises(requests.exceptions.RequestException):
+            self.download()
+        old_etag = self.server.etag
+        received = os.path.getsize(self.partial)
+        data = os.urandom(200000)
+        self.serve(data)
+        self.download()
+        # If-Range doesn't match, so the server sends it all
+        self.assertEqual(self.server.requests, [("bytes=%d-" % received, old_etag)])
+        self.assertEqual(self.read(self.output), data)
+
+    def test_restart_when_nothing_left(self):
+        data = self.server.data
+        with open(self.partial, "wb") as f:
+            f.write(data)
+        with open(self.etag_file, "w") as f:
+            f.write(self.server.etag)
+        self.download()
+        self.assertEqual(
+            self.server.requests,
+            [("bytes=%d-" % len(data), self.server.etag), (None, None)],
+        )
+        self.assertEqual(self.read(self.output), data)
+
+    def test_etag_mismatch(self):
+        self.serve(self.server.data, md5_etag(b"something else"))
+        with self.assertRaises(myriota_download.ChecksumError):
+            self.download()
+        for f in (self.output, self.partial, self.etag_file):
+            self.assertFalse(os.path.exists(f))
+
+    def test_multipart_etag_not_checked(self):
+        data = self.server.data
+        self.serve(data, '"%s-2"' % hashlib.md5(b"parts").hexdigest())
+        self.download()
+        self.assertEqual(self.read(self.output), data)
+
+    def test_sha256(self):
+        data = self.server.data
+        self.download(hashlib.sha256(data).hexdigest().upper())
+        self.assertEqual(self.read(self.output), data)
+        os.remove(self.output)
+        with self.assertRaises(myriota_download.ChecksumError):
+            self.download(hashlib.sha256(b"something else").hexdigest())
+        self.assertFalse(os.path.exists(self.output))
+        self.assertFalse(os.path.exists(self.partial))
+
+    def test_cache(self):
+        data = self.server.data
+        cache_dir = os.path.join(self.dir.name, "cache")
+        key = "system_image_1_0.bin"
+        self.assertIsNone(myriota_download.cache_lookup(cache_dir, key))
+        cached = myriota_download.cached_download(self.url, cache_dir, key)
+        digest = hashlib.sha256(data).hexdigest()
+        self.assertEqual(os.path.basename(cached), digest)
+        self.assertEqual(myriota_download.cache_lookup(cache_dir, key), cached)
+        self.assertEqual(myriota_download.cache_lookup(cache_dir, key, digest), cached)
+        self.assertIsNone(myriota_download.cache_lookup(cache_dir, key, "0" * 64))
+        # A damaged object isn't used
+        with open(cached, "r+b") as f:
+            f.write(b"\0")
+        self.assertIsNone(myriota_download.cache_lookup(cache_dir, key))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright (c) 2025, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Splitter for messages packed by module/record_packer.c, a sequence of
+# records of a type byte, a length byte and that many bytes of data.
+# Usage:
+# unpack_records.py -x 0106010000003412020400000a00
+# or
+# echo "0106010000003412020400000a00" | unpack_records.py
+# Records of a type can be decoded with a struct format and field names:
+# unpack_records.py -r "1=<IH:Time,Count" -r "2=<hh:Latitude,Longitude"
+
+import argparse
+import fileinput
+import json
+import struct
+
+
+def split(packet):
+    """
+    Split a packed message, as bytes, into a list of (type, data). Type 0
+    ends the message, e.g. at padding.
+    """
+    records = []
+    offset = 0
+    while offset + 2 <= len(packet):
+        record_type, length = packet[offset], packet[offset + 1]
+        if record_type == 0:
+            break
+        offset += 2
+        if offset + length > len(packet):
+            raise ValueError("record of type %d is truncated" % record_type)
+        records.append((record_type, bytes(packet[offset : offset + length])))
+        offset += length
+    return records
+
+
+def parse_record_format(value):
+    """TYPE=FORMAT[:NAME,...], e.g. '1=<IH:Time,Count'"""
+    try:
+        record_type, spec = value.split("=", 1)
+        fmt, _, names = spec.partition(":")
+        unpacker = struct.Struct(fmt)
+        names = names.split(",") if names else None
+        return int(record_type, 0), (unpacker, names)
+    except (ValueError, struct.error):
+        raise argparse.ArgumentTypeError("invalid record format '%s'" % value)
+
+
+def unpack(packet, formats=None):
+    formats = formats or {}
+    d = []
+    for record_type, data in split(bytearray.fromhex(packet)):
+        record = {"Type": record_type}
+        if record_type in formats and len(data) == formats[record_type][0].size:
+            unpacker, names = formats[record_type]
+            values = unpacker.unpack(data)
+            if names:
+                record.update(zip(names, values))
+            else:
+                record["Values"] = list(values)
+        else:
+            record["Data"] = data.hex()
+        d.append(record)
+    return [d]
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Split hexadecimal messages packed by the record packer.",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    parser.add_argument(
+        "-x", "--hex", type=str, default="-", help="Packet data in hexadecimal format"
+    )
+    parser.add_argument(
+        "-r",
+        "--record",
+        dest="formats",
+        metavar="TYPE=FORMAT[:NAME,...]",
+        type=parse_record_format,
+        action="append",
+        default=[],
+        help="decode records of TYPE with a struct FORMAT into fields NAME",
+    )
+    args = parser.parse_args()
+    formats = dict(args.formats)
+
+    d = []
+    if args.hex == "-":
+        for line in fileinput.input(files=["-"]):
+            d = d + unpack(line.strip(), formats)
+    else:
+        d = d + unpack(args.hex, formats)
+
+    print(json.dumps(d))
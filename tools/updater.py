@@ -24,6 +24,8 @@ import signal
 import sys
 import time
 import struct
+import binascii
+import json
 import tempfile
 import platform
 import re
@@ -33,6 +35,9 @@ version = "1.4"
 
 
 FIRMWARE_START_ADDRESS = 0x4000
+USER_APP_START_ADDRESS = 0x27800  # FLASH ORIGIN in APP.ld
+FLASH_PAGE_SIZE = 2048
+IMAGE_CACHE_DIR = os.path.expanduser("~") + "/.cache/myriota/images"
 header_length = 16
 header_version = 0
 
@@ -41,6 +46,7 @@ FILE_TYPE_SYS_IMG = 1
 FILE_TYPE_USER_APP = 2
 FILE_TYPE_NETWORK_INFO = 3
 FILE_TYPE_SYS_IMG_2 = 4
+FILE_TYPE_INDEX = 0xFF  # merge_binary.py section index, not programmed
 
 
 file_types = {
@@ -56,12 +62,31 @@ COMMAND_BOOT = b"b"
 COMMAND_VERSION = b"V"
 COMMAND_REGCODE = b"g"
 COMMAND_ID = b"i"
+COMMAND_LOG_DUMP = b"x"
+
+# Log entry header and the "Application starts" code, as in log-util.py
+LOG_HEADER = struct.Struct("<IHH")
+LOG_APP_STARTS = 6
+
+
+class UnsupportedCommandError(RuntimeError):
+    pass
 
 
 RE_PATTERN_MODULE_ID = r"[\da-fA-F]{10}"
 RE_PATTERN_REGCODE = r"[\d\w]{25}"
 
 
+BAUDRATE_MIN = 9600
+BAUDRATE_MAX = 921600
+BAUDRATE_DEFAULT = 115200
+BAUDRATE_AUTO = "auto"
+# Candidate baudrates for automatic negotiation, fastest first
+AUTO_BAUDRATES = [921600, 460800, 230400, 115200, 57600, 38400, 19200, 9600]
+# Number of identical ID readbacks required to accept a baudrate
+READBACK_TEST_ROUNDS = 3
+
+
 class MyriotaUSBDevice:
     DisplayName = ""
     ChipType = ""
@@ -175,8 +200,34 @@ def calc_crc(data):
     return crc
 
 
+def make_delta(old, new, page_size=FLASH_PAGE_SIZE):
+    """
+    Compare two images page by page and return the changed pages as a list of
+    (offset, data) runs, with consecutive changed pages merged into one run.
+    Pages beyond the end of the new image are filled with 0xFF (erased flash).
+    """
+    size = max(len(old), len(new))
+    size = (size + page_size - 1) // page_size * page_size
+    old = bytes(old) + b"\xff" * (size - len(old))
+    new = bytes(new) + b"\xff" * (size - len(new))
+    runs = []
+    for offset in range(0, size, page_size):
+        page = new[offset : offset + page_size]
+        if page == old[offset : offset + page_size]:
+            continue
+        if runs and runs[-1][0] + len(runs[-1][1]) == offset:
+            runs[-1] = (runs[-1][0], runs[-1][1] + page)
+        else:
+            runs.append((offset, page))
+    return runs
+
+
 class MyriotaModuleUpdate:
     serial_port = None
+    port_name = None
+    baudrate = None
+    baudrate_auto = False
+    xmodem_naks = 0
 
     def __init__(
         self,
@@ -420,6 +471,54 @@ class MyriotaModuleUpdate:
 
         self.serial_port.reset_input_buffer()
 
+    def readback_test(self, rounds=READBACK_TEST_ROUNDS):
+        # Read the module ID back several times, the link is only considered
+        # reliable if every readback is well formed and identical
+        readbacks = set()
+        for i in range(rounds):
+            try:
+                out = self.execute_cmd_read(COMMAND_ID, max_retries=1)
+            except TimeoutError:
+                return False
+            if not re.match(RE_PATTERN_MODULE_ID, out):
+                return False
+            readbacks.add(out.strip())
+        return len(readbacks) == 1
+
+    def negotiate_baudrate(self, port_name, baudrates=AUTO_BAUDRATES):
+        # Settle on the fastest baudrate that passes the readback test
+        self.port_name = port_name
+        self.baudrate_auto = True
+        for br in baudrates:
+            self.close()
+            try:
+                self.open_serial_port(port_name, br)
+                self.capture_bootloader(port_name, br)
+            except RuntimeError:
+                continue
+            if self.readback_test():
+                self.baudrate = br
+                self.connect_msg("Negotiated baudrate", br)
+                return br
+        raise RuntimeError("failed to negotiate baudrate")
+
+    def step_down_baudrate(self):
+        lower = [br for br in AUTO_BAUDRATES if br < self.baudrate]
+        if not lower:
+            raise RuntimeError("no lower baudrate to fall back to")
+        self.update_msg(
+            "\nLink errors at %d, stepping down baudrate" % self.baudrate
+        )
+        return self.negotiate_baudrate(self.port_name, lower)
+
+    def connect_bootloader(self, port_name, br):
+        if br == BAUDRATE_AUTO:
+            return self.negotiate_baudrate(port_name)
+        self.port_name = port_name
+        self.baudrate = br
+        self.capture_bootloader(port_name, br)
+        return br
+
     def close(self):
         if self.serial_port is not None:
             self.serial_port.close()
@@ -463,6 +562,7 @@ class MyriotaModuleUpdate:
                 if answer == NAK:
                     if not quiet:
                         self.update_msg("!", end="")
+                    self.xmodem_naks += 1
                     retries += 1
                     if retries > MAX_RETRIES:
                         return False
@@ -501,6 +601,10 @@ class MyriotaModuleUpdate:
             out += self.serial_port.readline()
             out += self.serial_port.readline()
             out += self.serial_port.readline()
+            if b"Unknown" in out:
+                raise UnsupportedCommandError(
+                    "bootloader does not support command %s" % command
+                )
             ncg = False
             if b"C" in out:
                 ncg = True
@@ -545,7 +649,18 @@ class MyriotaModuleUpdate:
             "\nProgramming %s (%dK) " % (filename, (file_size + 1023) / 1024),
             end="",
         )
-        self._update_stream(command, stream)
+        while True:
+            self.xmodem_naks = 0
+            try:
+                self._update_stream(command, stream)
+                break
+            except UnsupportedCommandError:
+                raise
+            except RuntimeError:
+                # Only link errors are worth retrying at a lower baudrate
+                if not self.baudrate_auto or self.xmodem_naks == 0:
+                    raise
+                self.step_down_baudrate()
         self.update_msg("done")
 
     def jump_to_app(self):
@@ -579,6 +694,145 @@ class MyriotaModuleUpdate:
         except TimeoutError:
             raise RuntimeError("Failed to read regcode")
 
+    def get_module_id(self):
+        match = re.search(RE_PATTERN_MODULE_ID, self.get_id())
+        if match is None:
+            raise RuntimeError("Failed to read ID")
+        return match.group(0).lower()
+
+    def _image_cache_file(self, module_id, name="user_app.bin"):
+        return os.path.join(IMAGE_CACHE_DIR, module_id, name)
+
+    def read_app_starts(self):
+        """
+        Build hashes of the "Application starts" entries in the module log,
+        oldest first. The system image logs one each time an application starts.
+        """
+        self.serial_port.reset_input_buffer()
+        self.execute_cmd(COMMAND_LOG_DUMP)
+        hexdata = b""
+        while True:
+            out = self.serial_port.readline()
+            if len(out) == 0:
+                break
+            if len(out) > 16:
+                hexdata += out.strip()
+        data = binascii.unhexlify(hexdata[: len(hexdata) & ~1])
+        hashes = []
+        offset = 0
+        while offset + LOG_HEADER.size <= len(data):
+            timestamp, length, code = LOG_HEADER.unpack_from(data, offset)
+            if timestamp == 0xFFFFFFFF:
+                break
+            offset += LOG_HEADER.size
+            if code == LOG_APP_STARTS and offset + 8 <= len(data):
+                hashes.append(struct.unpack_from("<Q", data, offset)[0])
+            offset += (length + 3) & ~3
+        return hashes
+
+    def read_image(self, filename, handle=None):
+        try:
+            if handle is None:
+                with open(filename, "rb") as f:
+                    return f.read()
+            handle.seek(0)
+            return handle.read()
+        except IOError:
+            raise RuntimeError("Can't open %s" % filename)
+
+    def cache_user_app(self, module_id, image, starts):
+        # Remember the image last programmed to the module along with the
+        # number of application starts logged by then, see update_user_app_delta
+        cache_file = self._image_cache_file(module_id)
+        try:
+            os.makedirs(os.path.dirname(cache_file), exist_ok=True)
+            with open(cache_file, "wb") as f:
+                f.write(image)
+            with open(self._image_cache_file(module_id, "user_app.json"), "w") as f:
+                json.dump({"starts": starts}, f)
+        except OSError:
+            self.clear_user_app_cache(module_id)
+
+    def clear_user_app_cache(self, module_id):
+        for name in ["user_app.bin", "user_app.json"]:
+            cache_file = self._image_cache_file(module_id, name)
+            if os.path.exists(cache_file):
+                os.remove(cache_file)
+
+    def cached_user_app(self, module_id, hashes):
+        """
+        Returns the cached image if the module reports it is the application in
+        flash, None otherwise. The bootloader can't read flash back, so this
+        relies on the log: the application must have started since it was
+        programmed, and all starts since must be of the same build.
+        """
+        try:
+            with open(self._image_cache_file(module_id), "rb") as f:
+                cached = f.read()
+            with open(self._image_cache_file(module_id, "user_app.json")) as f:
+                starts = json.load(f)["starts"]
+        except (IOError, ValueError, KeyError, TypeError):
+            self.update_msg("\nNo cached image for %s, programming in full" % module_id)
+            return None
+        since = hashes[starts:] if isinstance(starts, int) and starts >= 0 else []
+        if len(hashes) < starts or not since:
+            self.update_msg(
+                "\nApplication on %s hasn't started since it was cached, programming in full"
+                % module_id
+            )
+            return None
+        if any(h != since[0] for h in since):
+            self.update_msg(
+                "\nAnother application has run on %s since it was cached, programming in full"
+                % module_id
+            )
+            return None
+        return cached
+
+    def update_user_app_delta(self, module_id, filename, image, handle=None):
+        try:
+            hashes = self.read_app_starts()
+        except (binascii.Error, struct.error):
+            raise RuntimeError("Failed to read the log")
+        # The cache is only trusted once, whatever happens next
+        cached = self.cached_user_app(module_id, hashes)
+        self.clear_user_app_cache(module_id)
+        if cached is None:
+            self.update_image("s", filename, handle)
+            self.cache_user_app(module_id, image, len(hashes))
+            return
+
+        runs = make_delta(cached, image)
+        if not runs:
+            self.update_msg("\n%s is already up to date" % filename)
+            self.cache_user_app(module_id, image, len(hashes) - 1)
+            return
+        pages = sum(len(d) for _, d in runs) // FLASH_PAGE_SIZE
+        total = (len(image) + FLASH_PAGE_SIZE - 1) // FLASH_PAGE_SIZE
+        self.update_msg(
+            "\nDelta update %s: %d of %d pages changed" % (filename, pages, total),
+            end="",
+        )
+        written = 0
+        try:
+            for offset, data in runs:
+                stream = tempfile.TemporaryFile()
+                stream.write(data)
+                self.update_image(
+                    "a%x" % (USER_APP_START_ADDRESS + offset),
+                    "%s@0x%x" % (filename, offset),
+                    stream,
+                )
+                written += 1
+        except UnsupportedCommandError:
+            if written:
+                raise
+            self.update_msg(
+                "\nBootloader does not support partial writes, programming in full"
+            )
+            self.update_image("s", filename, handle)
+        self.cache_user_app(module_id, image, len(hashes))
+
     def get_version(self):
         try:
             return self.execute_cmd_read(COMMAND_VERSION, max_retries=2)
@@ -604,7 +858,7 @@ class MyriotaModuleUpdate:
             while offset < totalsize:
                 input_file.seek(2, os.SEEK_CUR)
                 ftype = struct.unpack("<H", input_file.read(2))[0]
-                if not ftype in file_types:
+                if not ftype in file_types and ftype != FILE_TYPE_INDEX:
                     return False
 
                 flen = struct.unpack("<I", input_file.read(4))[0]
@@ -629,6 +883,8 @@ class MyriotaModuleUpdate:
                 ftype = struct.unpack("<H", input_file.read(2))[0]
                 flen = struct.unpack("<I", input_file.read(4))[0]
                 input_file.seek(8, os.SEEK_CUR)
+                if ftype == FILE_TYPE_INDEX:
+                    break
                 output_temp = tempfile.NamedTemporaryFile(mode="w+b", delete=False)
                 output_temp.write(input_file.read(flen))
                 if ftype == FILE_TYPE_SYS_IMG:
@@ -713,6 +969,14 @@ def main():
         help="user application or user application merged with network information FILE to update with",
         metavar="FILE",
     )
+    parser.add_argument(
+        "-e",
+        "--delta",
+        dest="delta_flag",
+        action="store_true",
+        default=False,
+        help="only program the user application flash pages changed since the image last programmed to the module by this tool with this option. The module log must show the application has started since, and only that build, otherwise the application is programmed in full",
+    )
     parser.add_argument(
         "-n",
         "--network_info",
@@ -796,8 +1060,9 @@ def main():
         "--baudrate",
         dest="baud_rate",
         metavar="BAUDRATE",
-        default=115200,
-        help="set the serial port BAUDRATE between 9600 and 921600",
+        default=BAUDRATE_DEFAULT,
+        help="set the serial port BAUDRATE between %d and %d, or '%s' to negotiate the fastest reliable one"
+        % (BAUDRATE_MIN, BAUDRATE_MAX, BAUDRATE_AUTO),
     )
 
     parser.add_argument(
@@ -865,37 +1130,40 @@ def main():
     if args.portname != "None":
         port_name = args.portname
 
-    if args.baud_rate:
-        if int(args.baud_rate) < 9600:
-            sys.stderr.write("Failed to set baudrate, minimum is 9600\n")
+    if args.baud_rate == BAUDRATE_AUTO:
+        br = BAUDRATE_AUTO
+        open_br = BAUDRATE_DEFAULT
+    elif args.baud_rate:
+        if int(args.baud_rate) < BAUDRATE_MIN:
+            sys.stderr.write("Failed to set baudrate, minimum is %d\n" % BAUDRATE_MIN)
             sys.exit(1)
-        elif int(args.baud_rate) > 921600:
-            sys.stderr.write("Failed to set baudrate, maximum is 921600\n")
+        elif int(args.baud_rate) > BAUDRATE_MAX:
+            sys.stderr.write("Failed to set baudrate, maximum is %d\n" % BAUDRATE_MAX)
             sys.exit(1)
         else:
-            br = args.baud_rate
+            br = open_br = args.baud_rate
     else:
-        br = 115200
+        br = open_br = BAUDRATE_DEFAULT
 
     if args.debug:
         print("Entering interactive debug mode")
-        cmd = "python -m serial.tools.miniterm --raw " + port_name + " " + str(br)
+        cmd = "python -m serial.tools.miniterm --raw " + port_name + " " + str(open_br)
         os.system(cmd)
 
     if args.wait_flag:
         print("Waiting for serial port", port_name, br)
-        updater.wait_for_serial_port(port_name, br)
+        updater.wait_for_serial_port(port_name, open_br)
     else:
         print("Using serial port", port_name, br)
         try:
-            updater.open_serial_port(port_name, br)
+            updater.open_serial_port(port_name, open_br)
         except Exception as e:
             sys.stderr.write(str(e) + "\n")
             sys.exit(1)
 
     if args.get_id_flag:
         try:
-            updater.capture_bootloader(port_name, br)
+            updater.connect_bootloader(port_name, br)
             print("ID:", end="")
             print(updater.get_id())
             sys.exit(0)
@@ -905,7 +1173,7 @@ def main():
 
     if args.get_regcode_flag:
         try:
-            updater.capture_bootloader(port_name, br)
+            updater.connect_bootloader(port_name, br)
             print("Registration code:", end="")
             print(updater.get_regcode())
             sys.exit(0)
@@ -915,7 +1183,7 @@ def main():
 
     if args.get_version_flag:
         try:
-            updater.capture_bootloader(port_name, br)
+            updater.connect_bootloader(port_name, br)
             print(updater.get_version())
             sys.exit(0)
         except Exception as e:
@@ -970,9 +1238,32 @@ def main():
 
     if update_commands:
         try:
-            updater.capture_bootloader(port_name, br)
+            updater.connect_bootloader(port_name, br)
+            module_id = None
+            if any(d[0] == "s" for d in update_commands):
+                try:
+                    module_id = updater.get_module_id()
+                except RuntimeError:
+                    if args.delta_flag:
+                        print("Failed to read ID, programming in full")
             for d in update_commands:
-                updater.update_image(d[0], d[1], d[2])
+                if d[0] == "s" and module_id is not None:
+                    try:
+                        if args.delta_flag:
+                            image = updater.read_image(d[1], d[2])
+                            updater.update_user_app_delta(
+                                module_id, d[1], image, d[2]
+                            )
+                        else:
+                            # Programmed by other means as far as delta
+                            # updates are concerned
+                            updater.clear_user_app_cache(module_id)
+                            updater.update_image(d[0], d[1], d[2])
+                    except Exception:
+                        updater.clear_user_app_cache(module_id)
+                        raise
+                else:
+                    updater.update_image(d[0], d[1], d[2])
             print("\nUpdate done!\n")
         except Exception as e:
             updater.close()